@@ -0,0 +1,343 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "benchmark.h"
+#include "simulation.h"
+#include "pool.h"
+#include "deck.h"
+#include "cpu.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SCORE_N0_PRODUCT 1000000.0  // SCORE * N0, see SCORE_SCALE in betting.c
+
+void benchmark_config_standard(BenchmarkConfig* config) {
+    memset(config, 0, sizeof(*config));
+    rules_init(&config->rules);
+    basic_strategy_init(&config->strategy);
+
+    config->num_systems = count_system_num_builtin();
+    for (int i = 0; i < config->num_systems; i++) {
+        count_system_builtin(i, &config->systems[i]);
+    }
+
+    static const double max_bets[] = { 8, 12, 16 };
+    config->num_spreads = sizeof(max_bets) / sizeof(max_bets[0]);
+    for (int i = 0; i < config->num_spreads; i++) {
+        BetRampSolverConfig* spread = &config->spreads[i];
+        spread->bankroll = 1000;
+        spread->min_bet = 1;
+        spread->max_bet = max_bets[i];
+        spread->bet_increment = 1;
+        spread->kelly_fraction = 1.0;
+        spread->max_risk_of_ruin = 0;
+    }
+
+    static const double penetrations[] = { 0.67, 0.75, 0.83 };
+    config->num_penetrations = sizeof(penetrations) / sizeof(penetrations[0]);
+    memcpy(config->penetrations, penetrations, sizeof(penetrations));
+
+    config->rounds_per_penetration = 4000000;
+    config->num_batches = 64;
+    config->seed = 20240601;
+    config->num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+// Batch b of every penetration deals the same shoes, so columns differ by
+// penetration rather than by luck of the draw. Every shoe is addressed by
+// (seed, shoe index) alone, whichever thread deals it.
+uint64_t benchmark_batch_first_shoe(int batch) {
+    return (uint64_t)batch * DECK_SHOES_PER_INIT;
+}
+
+static void batch_config(const BenchmarkConfig* config, int penetration, int batch, SimulationConfig* simulation_config) {
+    memset(simulation_config, 0, sizeof(*simulation_config));
+    simulation_config->rules = config->rules;
+    simulation_config->rules.shoe_penetration = config->penetrations[penetration];
+    simulation_config->strategy = config->strategy;
+    simulation_config->bet_per_hand = 1.0;
+    simulation_config->count_systems = config->systems;
+    simulation_config->num_count_systems = config->num_systems;
+    simulation_config->seed = (uint32_t)config->seed;
+    simulation_config->first_shoe = benchmark_batch_first_shoe(batch);
+    simulation_config->num_hands = config->rounds_per_penetration / config->num_batches +
+                                   (batch < config->rounds_per_penetration % config->num_batches ? 1 : 0);
+}
+
+// Batch-means interval around the pooled estimate
+static BenchmarkInterval batch_interval(double pooled, const double* batch_values, int num_batches) {
+    BenchmarkInterval interval = { pooled, pooled, pooled };
+    if (num_batches < 2) {
+        return interval;
+    }
+
+    double mean = 0.0;
+    for (int i = 0; i < num_batches; i++) {
+        mean += batch_values[i];
+    }
+    mean /= num_batches;
+
+    double sum_squares = 0.0;
+    for (int i = 0; i < num_batches; i++) {
+        sum_squares += (batch_values[i] - mean) * (batch_values[i] - mean);
+    }
+
+    double half_width = BENCHMARK_CONFIDENCE_Z * sqrt(sum_squares / (num_batches - 1) / num_batches);
+    interval.lower = pooled - half_width;
+    interval.upper = pooled + half_width;
+    return interval;
+}
+
+static void score_cell(const BenchmarkConfig* config, const BetRampSolverConfig* spread,
+                       const CountTable* batch_tables, int system, BenchmarkCell* cell) {
+    CountTable pooled = {0};
+    for (int b = 0; b < config->num_batches; b++) {
+        count_table_add(&pooled, &batch_tables[b * config->num_systems + system]);
+    }
+
+    BetRampStats stats;
+    bet_ramp_solve(&pooled, spread, &cell->ramp);
+    bet_ramp_evaluate(&cell->ramp, &pooled, spread->bankroll, &stats);
+    cell->average_bet = stats.average_bet;
+
+    double win_rates[BENCHMARK_MAX_BATCHES];
+    double std_devs[BENCHMARK_MAX_BATCHES];
+    for (int b = 0; b < config->num_batches; b++) {
+        BetRampStats batch_stats;
+        bet_ramp_evaluate(&cell->ramp, &batch_tables[b * config->num_systems + system], spread->bankroll, &batch_stats);
+        win_rates[b] = batch_stats.win_rate;
+        std_devs[b] = batch_stats.std_dev;
+    }
+
+    cell->win_rate = batch_interval(stats.win_rate, win_rates, config->num_batches);
+    cell->std_dev = batch_interval(stats.std_dev, std_devs, config->num_batches);
+
+    // The win rate is far noisier than the SD, so SCORE, N0 and risk of ruin
+    // take their intervals from the ends of the win-rate interval
+    double lower_win_rate = cell->win_rate.lower > 0 ? cell->win_rate.lower : 0.0;
+    double upper_win_rate = cell->win_rate.upper > 0 ? cell->win_rate.upper : 0.0;
+    double variance = stats.std_dev * stats.std_dev;
+
+    cell->score.mean = stats.score;
+    cell->score.lower = variance > 0 ? SCORE_N0_PRODUCT * lower_win_rate * lower_win_rate / variance : 0.0;
+    cell->score.upper = variance > 0 ? SCORE_N0_PRODUCT * upper_win_rate * upper_win_rate / variance : 0.0;
+
+    cell->n0.mean = stats.n0;
+    cell->n0.lower = cell->score.upper > 0 ? SCORE_N0_PRODUCT / cell->score.upper : INFINITY;
+    cell->n0.upper = cell->score.lower > 0 ? SCORE_N0_PRODUCT / cell->score.lower : INFINITY;
+
+    cell->risk_of_ruin.mean = stats.risk_of_ruin;
+    cell->risk_of_ruin.lower = bet_ramp_risk_of_ruin(cell->win_rate.upper, stats.std_dev, spread->bankroll);
+    cell->risk_of_ruin.upper = bet_ramp_risk_of_ruin(cell->win_rate.lower, stats.std_dev, spread->bankroll);
+}
+
+// Every count the result arrays and per-cell buffers are sized for
+bool benchmark_config_valid(const BenchmarkConfig* config) {
+    return config->num_batches >= 1 && config->num_batches <= BENCHMARK_MAX_BATCHES &&
+           config->num_systems >= 1 && config->num_systems <= COUNT_MAX_SYSTEMS &&
+           config->num_spreads >= 1 && config->num_spreads <= BENCHMARK_MAX_SPREADS &&
+           config->num_penetrations >= 1 && config->num_penetrations <= BENCHMARK_MAX_PENETRATIONS &&
+           config->rounds_per_penetration >= config->num_batches && config->seed != 0;
+}
+
+bool benchmark_run(const BenchmarkConfig* config, BenchmarkResults* results) {
+    if (!benchmark_config_valid(config)) {
+        return false;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Every batch is a one-task job on the pool. Batches own their seed and
+    // output slot, so the numbers don't depend on how many threads run them.
+    int num_tasks = config->num_penetrations * config->num_batches;
+    Pool pool;
+    pool_init(&pool, config->num_threads > 0 ? config->num_threads : 1);
+    for (int task = 0; task < num_tasks; task++) {
+        SimulationConfig simulation_config;
+        batch_config(config, task / config->num_batches, task % config->num_batches, &simulation_config);
+        pool_add_job(&pool, &simulation_config, simulation_config.num_hands);
+    }
+    if (!pool_run(&pool)) {
+        pool_destroy(&pool);
+        return false;
+    }
+
+    CountTable* all_batch_tables = calloc((size_t)num_tasks * config->num_systems, sizeof(CountTable));
+    long* batch_rounds = calloc(num_tasks, sizeof(long));
+    for (int task = 0; task < num_tasks; task++) {
+        SimulationResults* batch_results = pool_job_results(&pool, task);
+        memcpy(&all_batch_tables[task * config->num_systems], batch_results->count_tables,
+               sizeof(CountTable) * config->num_systems);
+        batch_rounds[task] = batch_results->hands_played;
+    }
+    pool_destroy(&pool);
+
+    for (int p = 0; p < config->num_penetrations; p++) {
+        const CountTable* batch_tables = &all_batch_tables[(size_t)p * config->num_batches * config->num_systems];
+
+        results->rounds[p] = 0;
+        for (int b = 0; b < config->num_batches; b++) {
+            results->rounds[p] += batch_rounds[p * config->num_batches + b];
+        }
+
+        for (int s = 0; s < config->num_spreads; s++) {
+            for (int c = 0; c < config->num_systems; c++) {
+                score_cell(config, &config->spreads[s], batch_tables, c, &results->cells[p][s][c]);
+            }
+        }
+    }
+
+    free(all_batch_tables);
+    free(batch_rounds);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    results->seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    return true;
+}
+
+void benchmark_print(FILE* out, const BenchmarkConfig* config, const BenchmarkResults* results) {
+    fprintf(out, "Count system benchmark: %d decks, %s, seed %d, %d batches, %s kernels, %.1fs\n",
+            config->rules.num_decks, config->rules.dealer_hits_soft_17 ? "H17" : "S17",
+            config->seed, config->num_batches, cpu_level_name(cpu_level()), results->seconds);
+
+    for (int p = 0; p < config->num_penetrations; p++) {
+        for (int s = 0; s < config->num_spreads; s++) {
+            const BetRampSolverConfig* spread = &config->spreads[s];
+            fprintf(out, "\nPenetration %.0f%%, spread %g-%g, bankroll %g units, %ld rounds\n",
+                    100.0 * config->penetrations[p], spread->min_bet, spread->max_bet,
+                    spread->bankroll, results->rounds[p]);
+            fprintf(out, "  %-10s %21s %21s %6s %22s %20s\n",
+                    "System", "SCORE", "Win/100 rounds", "SD", "N0", "RoR");
+
+            for (int c = 0; c < config->num_systems; c++) {
+                const BenchmarkCell* cell = &results->cells[p][s][c];
+                fprintf(out, "  %-10s %5.1f [%5.1f, %5.1f] %+5.2f [%+5.2f, %+5.2f] %6.3f %6.0f [%6.0f, %6.0f] %5.1f%% [%5.1f, %5.1f]\n",
+                        config->systems[c].name,
+                        cell->score.mean, cell->score.lower, cell->score.upper,
+                        100.0 * cell->win_rate.mean, 100.0 * cell->win_rate.lower, 100.0 * cell->win_rate.upper,
+                        cell->std_dev.mean,
+                        cell->n0.mean, cell->n0.lower, cell->n0.upper,
+                        100.0 * cell->risk_of_ruin.mean, 100.0 * cell->risk_of_ruin.lower,
+                        100.0 * cell->risk_of_ruin.upper);
+            }
+        }
+    }
+}
+
+void benchmark_scaling_config_standard(BenchmarkScalingConfig* config) {
+    memset(config, 0, sizeof(*config));
+    rules_init(&config->rules);
+    basic_strategy_init(&config->strategy);
+    config->max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    config->rounds = 8000000;
+    config->weak = false;
+    config->pinning = POOL_PIN_NONE;
+    config->seed = 20240601;
+}
+
+static double seconds_since(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// false if the pool couldn't start every thread the step is timed with, or
+// couldn't run every task
+static bool scaling_step(const BenchmarkScalingConfig* config, int threads, int rounds_per_task, BenchmarkScalingStep* step) {
+    SimulationConfig simulation_config = {0};
+    simulation_config.rules = config->rules;
+    simulation_config.strategy = config->strategy;
+    simulation_config.bet_per_hand = 1.0;
+    simulation_config.count_systems = config->num_systems > 0 ? config->systems : NULL;
+    simulation_config.num_count_systems = config->num_systems;
+    simulation_config.seed = (uint32_t)config->seed;
+
+    Pool pool;
+    if (!pool_init_pinned(&pool, threads, config->pinning) || pool.num_threads != threads) {
+        pool_destroy(&pool);
+        return false;
+    }
+
+    // Warm up every worker's shoes and games on shoes the timed run never deals
+    SimulationResults results;
+    simulation_config.num_hands = rounds_per_task * threads;
+    simulation_config.first_shoe = (uint64_t)1 << 62;
+    if (!pool_simulate(&pool, &simulation_config, rounds_per_task, &results)) {
+        pool_destroy(&pool);
+        return false;
+    }
+
+    simulation_config.num_hands = config->weak ? config->rounds * threads : config->rounds;
+    simulation_config.first_shoe = 0;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool ok = pool_simulate(&pool, &simulation_config, rounds_per_task, &results);
+    step->seconds = seconds_since(&start);
+    pool_destroy(&pool);
+    if (!ok) {
+        return false;
+    }
+
+    step->threads = threads;
+    step->rounds = results.hands_played + results.rounds_sat_out;
+    step->hands_per_second = step->rounds / step->seconds;
+    step->hands_per_second_per_thread = step->hands_per_second / threads;
+    step->ev = simulation_get_ev(&results);
+    return true;
+}
+
+bool benchmark_scaling_run(const BenchmarkScalingConfig* config, BenchmarkScalingResults* results) {
+    int max_threads = config->max_threads > 0 ? config->max_threads : 1;
+
+    // Fixed across steps: a strong-scaling job is cut into the same tasks at
+    // every thread count, which keeps counted results identical too
+    int strong_tasks = max_threads * BENCHMARK_SCALING_TASKS_PER_THREAD;
+    int rounds_per_task = config->weak ? config->rounds / BENCHMARK_SCALING_TASKS_PER_THREAD
+                                       : (config->rounds + strong_tasks - 1) / strong_tasks;
+    if (rounds_per_task < 1) {
+        rounds_per_task = 1;
+    }
+
+    results->num_steps = 0;
+    results->num_nodes = pool_num_nodes();
+    for (int threads = 1; results->num_steps < BENCHMARK_MAX_SCALING_STEPS; threads *= 2) {
+        if (threads > max_threads) {
+            threads = max_threads;
+        }
+
+        BenchmarkScalingStep* step = &results->steps[results->num_steps++];
+        if (!scaling_step(config, threads, rounds_per_task, step)) {
+            return false;
+        }
+        step->speedup = step->hands_per_second / results->steps[0].hands_per_second;
+        step->efficiency = step->speedup / threads;
+
+        if (threads == max_threads) {
+            break;
+        }
+    }
+    return true;
+}
+
+void benchmark_scaling_print(FILE* out, const BenchmarkScalingConfig* config, const BenchmarkScalingResults* results) {
+    static const char* pinning_names[] = { "none", "cores", "nodes" };
+    fprintf(out, "%s scaling: %s, %d rounds %s, pinning %s, %d NUMA node%s, %s kernels\n",
+            config->weak ? "Weak" : "Strong",
+            config->num_systems > 0 ? "counted shoes" : "fresh shoes (lane engine)",
+            config->rounds, config->weak ? "per thread" : "per step",
+            pinning_names[config->pinning], results->num_nodes, results->num_nodes == 1 ? "" : "s",
+            cpu_level_name(cpu_level()));
+    fprintf(out, "%8s %12s %9s %14s %16s %8s %10s %9s\n",
+            "Threads", "Rounds", "Seconds", "Hands/sec", "Hands/sec/core", "Speedup", "Efficiency", "EV");
+
+    for (int i = 0; i < results->num_steps; i++) {
+        const BenchmarkScalingStep* step = &results->steps[i];
+        fprintf(out, "%8d %12ld %9.3f %14.0f %16.0f %7.2fx %9.1f%% %+8.4f%%\n",
+                step->threads, step->rounds, step->seconds, step->hands_per_second,
+                step->hands_per_second_per_thread, step->speedup, 100.0 * step->efficiency, 100.0 * step->ev);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "rules.h"
+#include "strategy.h"
+#include "counting.h"
+#include "betting.h"
+#include "pool.h"
+
+#define BENCHMARK_MAX_PENETRATIONS 8
+#define BENCHMARK_MAX_SPREADS 8
+#define BENCHMARK_MAX_BATCHES 256
+#define BENCHMARK_CONFIDENCE_Z 1.96  // 95% two-sided intervals
+#define BENCHMARK_MAX_SCALING_STEPS 16
+#define BENCHMARK_SCALING_TASKS_PER_THREAD 8  // At the largest thread count, so stealing can even out the tail
+
+// A matrix of count systems x bet spreads x penetrations. Every penetration is
+// one simulation: all systems are counted from the same shoes and every spread
+// is scored from the same recorded tables.
+typedef struct {
+    Rules rules;                       // shoe_penetration is overridden per column
+    BasicStrategy strategy;
+    CountSystem systems[COUNT_MAX_SYSTEMS];
+    int num_systems;
+    BetRampSolverConfig spreads[BENCHMARK_MAX_SPREADS];
+    int num_spreads;
+    double penetrations[BENCHMARK_MAX_PENETRATIONS];
+    int num_penetrations;
+    int rounds_per_penetration;
+    int num_batches;                   // Independent shoe sequences per penetration, also the batch-means sample size
+    int seed;                          // Nonzero; same seed = same numbers for any thread count
+    int num_threads;
+} BenchmarkConfig;
+
+typedef struct {
+    double mean;
+    double lower;
+    double upper;
+} BenchmarkInterval;
+
+typedef struct {
+    BetRamp ramp;                      // Solved against all rounds for this penetration
+    double average_bet;
+    BenchmarkInterval win_rate;
+    BenchmarkInterval std_dev;
+    BenchmarkInterval score;
+    BenchmarkInterval n0;
+    BenchmarkInterval risk_of_ruin;
+} BenchmarkCell;
+
+typedef struct {
+    long rounds[BENCHMARK_MAX_PENETRATIONS];
+    BenchmarkCell cells[BENCHMARK_MAX_PENETRATIONS][BENCHMARK_MAX_SPREADS][COUNT_MAX_SYSTEMS];
+    double seconds;
+} BenchmarkResults;
+
+// The simulator at 1, 2, 4, ... threads, up to and including max_threads.
+// Strong scaling keeps the job fixed, so every step reports the same EV; weak
+// scaling grows it with the thread count.
+typedef struct {
+    Rules rules;
+    BasicStrategy strategy;
+    CountSystem systems[COUNT_MAX_SYSTEMS];
+    int num_systems;                   // 0 = flat bets on fresh shoes (the lane engine); else counted shoes
+    int max_threads;
+    int rounds;                        // Strong: per step; weak: per thread
+    bool weak;
+    PoolPinning pinning;
+    int seed;                          // Nonzero
+} BenchmarkScalingConfig;
+
+typedef struct {
+    int threads;
+    long rounds;
+    double seconds;
+    double hands_per_second;
+    double hands_per_second_per_thread;
+    double speedup;                    // Throughput against one thread
+    double efficiency;                 // speedup / threads
+    double ev;
+} BenchmarkScalingStep;
+
+typedef struct {
+    BenchmarkScalingStep steps[BENCHMARK_MAX_SCALING_STEPS];
+    int num_steps;
+    int num_nodes;
+} BenchmarkScalingResults;
+
+void benchmark_config_standard(BenchmarkConfig* config);
+
+uint64_t benchmark_batch_first_shoe(int batch);
+
+bool benchmark_config_valid(const BenchmarkConfig* config);
+
+// false unless benchmark_config_valid (nothing run) or if the pool fails
+bool benchmark_run(const BenchmarkConfig* config, BenchmarkResults* results);
+
+void benchmark_print(FILE* out, const BenchmarkConfig* config, const BenchmarkResults* results);
+
+void benchmark_scaling_config_standard(BenchmarkScalingConfig* config);
+
+// false if a step's pool couldn't start all its threads or run its tasks
+bool benchmark_scaling_run(const BenchmarkScalingConfig* config, BenchmarkScalingResults* results);
+
+void benchmark_scaling_print(FILE* out, const BenchmarkScalingConfig* config, const BenchmarkScalingResults* results);
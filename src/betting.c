@@ -0,0 +1,194 @@
+#include "betting.h"
+#include <math.h>
+
+#define SCORE_SCALE 1000000.0          // SCORE: win rate per 100 rounds on a 10,000 unit bankroll
+#define RISK_SCAN_STEPS 200
+#define RISK_SEARCH_ITERATIONS 40
+
+void bet_ramp_flat(BetRamp* ramp, double units) {
+    for (int i = 0; i < COUNT_NUM_BUCKETS; i++) {
+        ramp->units[i] = units;
+    }
+}
+
+// Pool-adjacent-violators fit of a non-decreasing EV curve, weighted by how
+// many rounds each bucket saw. Sparse buckets at the extremes are noisy, and
+// a raw per-bucket Kelly bet would chase that noise up and down the ramp.
+static void fit_monotone_ev(const CountTable* table, double* fitted_ev) {
+    double block_ev[COUNT_NUM_BUCKETS];
+    double block_weight[COUNT_NUM_BUCKETS];
+    int block_size[COUNT_NUM_BUCKETS];
+    int num_blocks = 0;
+
+    for (int i = 0; i < COUNT_NUM_BUCKETS; i++) {
+        block_ev[num_blocks] = count_bucket_ev(&table->buckets[i]);
+        block_weight[num_blocks] = (double)table->buckets[i].rounds;
+        block_size[num_blocks] = 1;
+        num_blocks++;
+
+        while (num_blocks > 1 && block_ev[num_blocks - 2] > block_ev[num_blocks - 1]) {
+            double weight = block_weight[num_blocks - 2] + block_weight[num_blocks - 1];
+            if (weight > 0) {
+                block_ev[num_blocks - 2] = (block_ev[num_blocks - 2] * block_weight[num_blocks - 2] +
+                                            block_ev[num_blocks - 1] * block_weight[num_blocks - 1]) / weight;
+            }
+            block_weight[num_blocks - 2] = weight;
+            block_size[num_blocks - 2] += block_size[num_blocks - 1];
+            num_blocks--;
+        }
+    }
+
+    int bucket = 0;
+    for (int b = 0; b < num_blocks; b++) {
+        for (int i = 0; i < block_size[b]; i++) {
+            fitted_ev[bucket++] = block_ev[b];
+        }
+    }
+}
+
+// Kelly bet for every bucket (scale * bankroll * ev / variance) on the fitted
+// EV curve, clamped to the table limits and kept non-decreasing after chip
+// rounding.
+static void build_kelly_ramp(const CountTable* table, const BetRampSolverConfig* solver, double scale, BetRamp* ramp) {
+    double fitted_ev[COUNT_NUM_BUCKETS];
+    fit_monotone_ev(table, fitted_ev);
+    double previous = solver->min_bet;
+
+    for (int i = 0; i < COUNT_NUM_BUCKETS; i++) {
+        const CountBucket* bucket = &table->buckets[i];
+        double units = solver->min_bet;
+        double variance = count_bucket_variance(bucket);
+        double ev = fitted_ev[i];
+
+        if (bucket->rounds > 0 && variance > 0 && ev > 0) {
+            units = scale * solver->bankroll * ev / variance;
+        }
+
+        if (units > solver->max_bet) {
+            units = solver->max_bet;
+        }
+        if (solver->bet_increment > 0) {
+            units = floor(units / solver->bet_increment) * solver->bet_increment;
+        }
+        if (units < previous) {
+            units = previous;
+        }
+
+        ramp->units[i] = units;
+        previous = units;
+    }
+}
+
+bool bet_ramp_solve(const CountTable* table, const BetRampSolverConfig* solver, BetRamp* ramp) {
+    BetRampStats stats;
+
+    build_kelly_ramp(table, solver, solver->kelly_fraction, ramp);
+    if (solver->max_risk_of_ruin <= 0) {
+        return true;
+    }
+
+    bet_ramp_evaluate(ramp, table, solver->bankroll, &stats);
+    if (stats.risk_of_ruin <= solver->max_risk_of_ruin) {
+        return true;
+    }
+
+    // Shrink the Kelly multiplier until the ramp meets the risk-of-ruin target.
+    // Risk isn't monotone in the multiplier (too small a ramp can't beat the
+    // house edge at all), so scan down from the requested fraction and then
+    // bisect the first step that qualifies. Every candidate is scored against
+    // the same recorded table, so this costs a few thousand multiply-adds
+    // instead of a simulation per candidate.
+    double best_scale = 0.0;
+    double best_risk = stats.risk_of_ruin;
+    double rejected_scale = solver->kelly_fraction;
+    bool feasible = false;
+
+    for (int i = RISK_SCAN_STEPS - 1; i > 0 && !feasible; i--) {
+        double scale = solver->kelly_fraction * i / RISK_SCAN_STEPS;
+        build_kelly_ramp(table, solver, scale, ramp);
+        bet_ramp_evaluate(ramp, table, solver->bankroll, &stats);
+
+        if (stats.risk_of_ruin <= solver->max_risk_of_ruin) {
+            feasible = true;
+            best_scale = scale;
+        } else {
+            if (stats.risk_of_ruin < best_risk) {
+                best_risk = stats.risk_of_ruin;
+                best_scale = scale;
+            }
+            rejected_scale = scale;
+        }
+    }
+
+    if (feasible) {
+        double low = best_scale;
+        double high = rejected_scale;
+        for (int i = 0; i < RISK_SEARCH_ITERATIONS; i++) {
+            double mid = (low + high) / 2;
+            build_kelly_ramp(table, solver, mid, ramp);
+            bet_ramp_evaluate(ramp, table, solver->bankroll, &stats);
+
+            if (stats.risk_of_ruin <= solver->max_risk_of_ruin) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        best_scale = low;
+    }
+
+    // Infeasible targets fall back to the least risky ramp found
+    build_kelly_ramp(table, solver, best_scale, ramp);
+    return feasible;
+}
+
+void bet_ramp_evaluate(const BetRamp* ramp, const CountTable* table, double bankroll, BetRampStats* stats) {
+    double rounds = 0.0;
+    double total_result = 0.0;
+    double total_result_squared = 0.0;
+    double total_units = 0.0;
+
+    for (int i = 0; i < COUNT_NUM_BUCKETS; i++) {
+        const CountBucket* bucket = &table->buckets[i];
+        double units = ramp->units[i];
+
+        rounds += bucket->rounds;
+        total_result += units * bucket->total_result;
+        total_result_squared += units * units * bucket->total_result_squared;
+        total_units += units * bucket->rounds;
+    }
+
+    stats->win_rate = 0.0;
+    stats->std_dev = 0.0;
+    stats->average_bet = 0.0;
+    stats->risk_of_ruin = 1.0;
+    stats->score = 0.0;
+    stats->n0 = INFINITY;
+
+    if (rounds == 0) {
+        return;
+    }
+
+    stats->win_rate = total_result / rounds;
+    stats->average_bet = total_units / rounds;
+    double variance = total_result_squared / rounds - stats->win_rate * stats->win_rate;
+    stats->std_dev = variance > 0 ? sqrt(variance) : 0.0;
+    stats->risk_of_ruin = bet_ramp_risk_of_ruin(stats->win_rate, stats->std_dev, bankroll);
+
+    if (stats->std_dev > 0 && stats->win_rate != 0) {
+        double ratio = stats->win_rate / stats->std_dev;
+        stats->score = stats->win_rate > 0 ? ratio * ratio * SCORE_SCALE : 0.0;
+        stats->n0 = 1.0 / (ratio * ratio);
+    }
+}
+
+double bet_ramp_risk_of_ruin(double win_rate, double std_dev, double bankroll) {
+    if (win_rate <= 0) {
+        return 1.0;
+    }
+    if (std_dev <= 0) {
+        return 0.0;
+    }
+
+    return exp(-2.0 * win_rate * bankroll / (std_dev * std_dev));
+}
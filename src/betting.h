@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include "counting.h"
+
+typedef struct {
+    double units[COUNT_NUM_BUCKETS];  // Bet per true-count bucket, in multiples of bet_per_hand
+} BetRamp;
+
+typedef struct {
+    double bankroll;          // In units of bet_per_hand
+    double min_bet;           // Table minimum, in units
+    double max_bet;           // Table maximum (or spread cap), in units
+    double bet_increment;     // Round bets down to this chip size; 0 = no rounding
+    double kelly_fraction;    // 1.0 = full Kelly, 0.5 = half Kelly
+    double max_risk_of_ruin;  // 0 = unconstrained, otherwise e.g. 0.05 for 5%
+} BetRampSolverConfig;
+
+typedef struct {
+    double win_rate;      // Expected units won per round
+    double std_dev;       // Standard deviation per round, in units
+    double average_bet;   // Average units wagered per round (initial bet)
+    double risk_of_ruin;  // Against solver bankroll, 1.0 if win_rate <= 0
+    double score;         // (win_rate / std_dev)^2 * 1e6
+    double n0;            // Rounds to overcome one standard deviation
+} BetRampStats;
+
+typedef struct {
+    BetRampStats predicted;   // From the recorded table the ramp was solved against
+    BetRampStats observed;    // From a fresh simulation_run using the ramp
+    long observed_rounds;
+    double win_rate_std_error;  // Combined standard error of predicted and observed win rate
+} BetRampVerification;
+
+void bet_ramp_flat(BetRamp* ramp, double units);
+
+bool bet_ramp_solve(const CountTable* table, const BetRampSolverConfig* solver, BetRamp* ramp);
+
+void bet_ramp_evaluate(const BetRamp* ramp, const CountTable* table, double bankroll, BetRampStats* stats);
+
+double bet_ramp_risk_of_ruin(double win_rate, double std_dev, double bankroll);
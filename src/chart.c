@@ -0,0 +1,212 @@
+#include "chart.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define NUM_UPCARDS 10
+#define MAX_HANDS 10
+#define MAX_SYMBOLS 4
+#define MAX_LINE_LENGTH 256
+#define TOKEN_SEPARATORS " \t\r\n"
+
+static const char* upcard_labels[NUM_UPCARDS] = { "2", "3", "4", "5", "6", "7", "8", "9", "T", "A" };
+
+// One BasicStrategy member. Every member is a byte array indexed
+// [upcard][hand], so a cell is at offset + upcard * num_hands + hand.
+typedef struct {
+    const char* keyword;
+    size_t offset;
+    const char* hands[MAX_HANDS];
+    int num_hands;
+    const char* symbols[MAX_SYMBOLS];
+    uint8_t values[MAX_SYMBOLS];
+    int num_symbols;
+} ChartTable;
+
+static const ChartTable tables[] = {
+    { "hard", offsetof(BasicStrategy, hard_totals),
+      { "8", "9", "10", "11", "12", "13", "14", "15", "16" }, 9,
+      { "H", "S", "D" }, { HIT, STAND, DOUBLE }, 3 },
+    { "soft", offsetof(BasicStrategy, soft_totals),
+      { "13", "14", "15", "16", "17", "18", "19", "20" }, 8,
+      { "H", "S", "Dh", "Ds" }, { SOFT_HIT, SOFT_STAND, SOFT_DOUBLE_OR_HIT, SOFT_DOUBLE_OR_STAND }, 4 },
+    { "pair", offsetof(BasicStrategy, pairs),
+      { "2", "3", "4", "5", "6", "7", "8", "9", "T", "A" }, 10,
+      { "Y", "N", "Yd" }, { YES, NO, YES_IF_SPLIT_OFFERED }, 3 },
+    { "surrender", offsetof(BasicStrategy, surrender),
+      { "14", "15", "16" }, 3,
+      { "R", "-" }, { true, false }, 2 },
+};
+
+#define NUM_TABLES ((int)(sizeof(tables) / sizeof(tables[0])))
+
+static int find_label(const char* const* labels, int num_labels, const char* label) {
+    for (int i = 0; i < num_labels; i++) {
+        if (strcmp(labels[i], label) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool chart_valid_name(const char* name) {
+    if (*name == '\0' || strlen(name) >= CHART_NAME_LENGTH) {
+        return false;
+    }
+    for (const char* c = name; *c != '\0'; c++) {
+        if (!(*c == '_' || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read as bytes, so a file's stray values are caught before anything reads
+// them as actions or bools
+bool chart_strategy_valid(const BasicStrategy* strategy) {
+    for (int t = 0; t < NUM_TABLES; t++) {
+        const ChartTable* table = &tables[t];
+        const uint8_t* cells = (const uint8_t*)strategy + table->offset;
+        for (int c = 0; c < NUM_UPCARDS * table->num_hands; c++) {
+            if (memchr(table->values, cells[c], table->num_symbols) == NULL) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool read_row(const char* path, int line_number, char* keyword, BasicStrategy* strategy, bool seen[NUM_TABLES][MAX_HANDS]) {
+    int t = 0;
+    while (t < NUM_TABLES && strcmp(tables[t].keyword, keyword) != 0) {
+        t++;
+    }
+    if (t == NUM_TABLES) {
+        fprintf(stderr, "%s:%d: unknown row '%s'\n", path, line_number, keyword);
+        return false;
+    }
+
+    const ChartTable* table = &tables[t];
+    char* label = strtok(NULL, TOKEN_SEPARATORS);
+    int hand = label != NULL ? find_label(table->hands, table->num_hands, label) : -1;
+    if (hand < 0) {
+        fprintf(stderr, "%s:%d: '%s' needs a player hand\n", path, line_number, keyword);
+        return false;
+    }
+    if (seen[t][hand]) {
+        fprintf(stderr, "%s:%d: %s %s given twice\n", path, line_number, keyword, label);
+        return false;
+    }
+    seen[t][hand] = true;
+
+    uint8_t* cells = (uint8_t*)strategy + table->offset;
+    for (int up = 0; up < NUM_UPCARDS; up++) {
+        char* symbol = strtok(NULL, TOKEN_SEPARATORS);
+        if (symbol == NULL) {
+            fprintf(stderr, "%s:%d: %s %s has %d columns, expected %d\n", path, line_number, keyword, label, up, NUM_UPCARDS);
+            return false;
+        }
+
+        int s = find_label(table->symbols, table->num_symbols, symbol);
+        if (s < 0) {
+            fprintf(stderr, "%s:%d: '%s' is not a %s action\n", path, line_number, symbol, keyword);
+            return false;
+        }
+        cells[up * table->num_hands + hand] = table->values[s];
+    }
+
+    if (strtok(NULL, TOKEN_SEPARATORS) != NULL) {
+        fprintf(stderr, "%s:%d: %s %s has more than %d columns\n", path, line_number, keyword, label, NUM_UPCARDS);
+        return false;
+    }
+    return true;
+}
+
+// Every row must be present exactly once. Errors go to stderr as path:line.
+bool chart_read(FILE* in, const char* path, char name[CHART_NAME_LENGTH], BasicStrategy* strategy) {
+    bool seen[NUM_TABLES][MAX_HANDS] = {{false}};
+    char line[MAX_LINE_LENGTH];
+    int line_number = 0;
+    name[0] = '\0';
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        line_number++;
+        char* comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+
+        char* keyword = strtok(line, TOKEN_SEPARATORS);
+        if (keyword == NULL) {
+            continue;
+        }
+
+        if (strcmp(keyword, "chart") == 0) {
+            char* chart_name = strtok(NULL, TOKEN_SEPARATORS);
+            if (name[0] != '\0' || chart_name == NULL || !chart_valid_name(chart_name)) {
+                fprintf(stderr, "%s:%d: expected one 'chart NAME', NAME a C identifier under %d characters\n",
+                        path, line_number, CHART_NAME_LENGTH);
+                return false;
+            }
+            strcpy(name, chart_name);
+        } else if (!read_row(path, line_number, keyword, strategy, seen)) {
+            return false;
+        }
+    }
+
+    if (name[0] == '\0') {
+        fprintf(stderr, "%s: missing 'chart NAME'\n", path);
+        return false;
+    }
+    for (int t = 0; t < NUM_TABLES; t++) {
+        for (int h = 0; h < tables[t].num_hands; h++) {
+            if (!seen[t][h]) {
+                fprintf(stderr, "%s: missing row '%s %s'\n", path, tables[t].keyword, tables[t].hands[h]);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool chart_load(const char* path, char name[CHART_NAME_LENGTH], BasicStrategy* strategy) {
+    FILE* in = fopen(path, "r");
+    if (in == NULL) {
+        perror(path);
+        return false;
+    }
+
+    bool ok = chart_read(in, path, name, strategy);
+    fclose(in);
+    return ok;
+}
+
+// Writes a chart chart_read() reads back to the same strategy
+void chart_write(FILE* out, const char* name, const BasicStrategy* strategy) {
+    fprintf(out, "chart %s\n", name);
+    for (int t = 0; t < NUM_TABLES; t++) {
+        const ChartTable* table = &tables[t];
+        const uint8_t* cells = (const uint8_t*)strategy + table->offset;
+
+        fprintf(out, "\n#           ");
+        for (int up = 0; up < NUM_UPCARDS; up++) {
+            fprintf(out, up + 1 < NUM_UPCARDS ? "  %-2s" : "  %s", upcard_labels[up]);
+        }
+        fprintf(out, "\n");
+
+        for (int h = 0; h < table->num_hands; h++) {
+            fprintf(out, "%-9s %-2s", table->keyword, table->hands[h]);
+            for (int up = 0; up < NUM_UPCARDS; up++) {
+                uint8_t value = cells[up * table->num_hands + h];
+                const char* symbol = "?";
+                for (int s = 0; s < table->num_symbols; s++) {
+                    if (table->values[s] == value) {
+                        symbol = table->symbols[s];
+                    }
+                }
+                fprintf(out, up + 1 < NUM_UPCARDS ? "  %-2s" : "  %s", symbol);
+            }
+            fprintf(out, "\n");
+        }
+    }
+}
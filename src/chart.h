@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "strategy.h"
+
+#define CHART_NAME_LENGTH 48   // Including the terminator
+
+// The human-editable strategy format of charts/*.chart: a 'chart NAME' line,
+// then one row per player hand with the action against each dealer upcard.
+// tools/chartc.c compiles charts into C at build time; these read and write
+// them at run time.
+bool chart_read(FILE* in, const char* path, char name[CHART_NAME_LENGTH], BasicStrategy* strategy);
+
+bool chart_load(const char* path, char name[CHART_NAME_LENGTH], BasicStrategy* strategy);
+
+void chart_write(FILE* out, const char* name, const BasicStrategy* strategy);
+
+bool chart_valid_name(const char* name);
+
+// Every cell holds a value some chart symbol stands for
+bool chart_strategy_valid(const BasicStrategy* strategy);
@@ -0,0 +1,181 @@
+#include "counting.h"
+#include "card.h"
+#include <math.h>
+#include <string.h>
+
+#define NUM_CARDS_PER_DECK 52
+
+static const CountSystem builtin_systems[] = {
+    //                   A,  2,  3,  4,  5,  6,  7,  8,  9,  T
+    { "Hi-Lo",       {  -1,  1,  1,  1,  1,  1,  0,  0,  0, -1 } },
+    { "Hi-Opt I",    {   0,  0,  1,  1,  1,  1,  0,  0,  0, -1 } },
+    { "Hi-Opt II",   {   0,  1,  1,  2,  2,  1,  1,  0,  0, -2 } },
+    { "KO",          {  -1,  1,  1,  1,  1,  1,  1,  0,  0, -1 } },
+    { "Omega II",    {   0,  1,  1,  2,  2,  2,  1,  0, -1, -2 } },
+    { "Zen",         {  -1,  1,  1,  2,  2,  2,  1,  0,  0, -2 } },
+};
+
+#define NUM_BUILTIN_SYSTEMS ((int)(sizeof(builtin_systems) / sizeof(builtin_systems[0])))
+
+void count_system_hi_lo(CountSystem* system) {
+    *system = builtin_systems[0];
+}
+
+int count_system_num_builtin(void) {
+    return NUM_BUILTIN_SYSTEMS;
+}
+
+void count_system_builtin(int index, CountSystem* system) {
+    *system = builtin_systems[index];
+}
+
+bool count_system_by_name(const char* name, CountSystem* system) {
+    for (int i = 0; i < NUM_BUILTIN_SYSTEMS; i++) {
+        if (strcmp(builtin_systems[i].name, name) == 0) {
+            *system = builtin_systems[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Tags summed over a 52-card deck: four of each rank, sixteen tens
+static int tags_per_deck(const CountSystem* system) {
+    int sum = 0;
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        sum += system->tags[r] * (r == COUNT_NUM_RANKS - 1 ? 16 : 4);
+    }
+    return sum;
+}
+
+bool count_system_is_balanced(const CountSystem* system) {
+    return tags_per_deck(system) == 0;
+}
+
+int count_system_initial_count(const CountSystem* system, int num_decks) {
+    return -tags_per_deck(system) * (num_decks - 1);
+}
+
+int count_rank_index(int card) {
+    int rank = card_rank(card);
+    if (rank > 9) {
+        return 9;  // J, Q, K count as tens
+    }
+    return rank;
+}
+
+void count_tracker_init(CountTracker* tracker, const CountSystem* systems, int num_systems, int num_decks) {
+    if (num_systems > COUNT_MAX_SYSTEMS) {
+        num_systems = COUNT_MAX_SYSTEMS;
+    }
+
+    // Transpose the tag vectors so each card rank holds one lane per system
+    for (int rank = 0; rank < COUNT_NUM_CARD_RANKS; rank++) {
+        CountLanes tags = {0};
+        for (int s = 0; s < num_systems; s++) {
+            tags[s] = (int16_t)systems[s].tags[count_rank_index(rank)];
+        }
+        tracker->card_tags[rank] = tags;
+    }
+
+    CountLanes initial = {0};
+    for (int s = 0; s < COUNT_MAX_SYSTEMS; s++) {
+        tracker->unbalanced[s] = s < num_systems && !count_system_is_balanced(&systems[s]);
+        if (tracker->unbalanced[s]) {
+            initial[s] = (int16_t)count_system_initial_count(&systems[s], num_decks);
+        }
+    }
+    tracker->initial_counts = initial;
+
+    tracker->num_systems = num_systems;
+    tracker->total_cards = num_decks * NUM_CARDS_PER_DECK;
+    count_tracker_reset(tracker);
+}
+
+void count_tracker_reset(CountTracker* tracker) {
+    tracker->running_counts = tracker->initial_counts;
+    tracker->cards_seen = 0;
+}
+
+void count_tracker_observe(CountTracker* tracker, int card) {
+    tracker->running_counts += tracker->card_tags[card_rank(card)];
+    tracker->cards_seen++;
+}
+
+int count_tracker_running_count(CountTracker* tracker, int system) {
+    return tracker->running_counts[system];
+}
+
+double count_tracker_true_count(CountTracker* tracker, int system) {
+    int cards_remaining = tracker->total_cards - tracker->cards_seen;
+    if (cards_remaining < 1) {
+        cards_remaining = 1;
+    }
+
+    return tracker->running_counts[system] / ((double)cards_remaining / NUM_CARDS_PER_DECK);
+}
+
+double count_tracker_index(CountTracker* tracker, int system) {
+    if (tracker->unbalanced[system]) {
+        return tracker->running_counts[system];
+    }
+    return count_tracker_true_count(tracker, system);
+}
+
+int count_tracker_bucket(CountTracker* tracker, int system) {
+    return count_bucket_for_true_count(count_tracker_index(tracker, system));
+}
+
+void count_tracker_buckets(CountTracker* tracker, int* buckets) {
+    for (int s = 0; s < tracker->num_systems; s++) {
+        buckets[s] = count_tracker_bucket(tracker, s);
+    }
+}
+
+int count_bucket_for_true_count(double true_count) {
+    int floored = (int)floor(true_count);
+    if (floored < COUNT_MIN_TRUE_COUNT) {
+        floored = COUNT_MIN_TRUE_COUNT;
+    } else if (floored > COUNT_MAX_TRUE_COUNT) {
+        floored = COUNT_MAX_TRUE_COUNT;
+    }
+
+    return floored - COUNT_MIN_TRUE_COUNT;
+}
+
+int count_bucket_true_count(int bucket) {
+    return bucket + COUNT_MIN_TRUE_COUNT;
+}
+
+void count_table_record(CountTable* table, int bucket, double result) {
+    CountBucket* entry = &table->buckets[bucket];
+    entry->rounds++;
+    entry->total_result += result;
+    entry->total_result_squared += result * result;
+}
+
+void count_table_add(CountTable* total, const CountTable* table) {
+    for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+        total->buckets[b].rounds += table->buckets[b].rounds;
+        total->buckets[b].total_result += table->buckets[b].total_result;
+        total->buckets[b].total_result_squared += table->buckets[b].total_result_squared;
+    }
+}
+
+double count_bucket_ev(const CountBucket* bucket) {
+    if (bucket->rounds == 0) {
+        return 0.0;
+    }
+
+    return bucket->total_result / bucket->rounds;
+}
+
+double count_bucket_variance(const CountBucket* bucket) {
+    if (bucket->rounds == 0) {
+        return 0.0;
+    }
+
+    double ev = count_bucket_ev(bucket);
+    return bucket->total_result_squared / bucket->rounds - ev * ev;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define COUNT_NUM_RANKS 10           // A, 2, 3, 4, 5, 6, 7, 8, 9, T (J/Q/K count as T)
+#define COUNT_NUM_CARD_RANKS 13      // A through K, as returned by card_rank()
+#define COUNT_MAX_SYSTEMS 16         // Tag systems tracked side by side in one vector
+#define COUNT_MIN_TRUE_COUNT -10     // True counts below this land in the lowest bucket
+#define COUNT_MAX_TRUE_COUNT 10      // True counts above this land in the highest bucket
+#define COUNT_NUM_BUCKETS (COUNT_MAX_TRUE_COUNT - COUNT_MIN_TRUE_COUNT + 1)
+
+typedef struct {
+    const char* name;
+    int tags[COUNT_NUM_RANKS];  // index 0 = Ace, 1 = Two, ..., 9 = Ten/face
+} CountSystem;
+
+// One 16-bit running count per tag system. Sixteen lanes fill a 256-bit
+// register, so a dealt card updates every system with a single vector add.
+typedef int16_t CountLanes __attribute__((vector_size(COUNT_MAX_SYSTEMS * sizeof(int16_t))));
+
+typedef struct {
+    CountLanes card_tags[COUNT_NUM_CARD_RANKS];  // Tags of every system, per card rank
+    CountLanes running_counts;
+    CountLanes initial_counts;                   // Each system's IRC: 0 when balanced
+    bool unbalanced[COUNT_MAX_SYSTEMS];          // Bucketed by running count, not true count
+    int num_systems;
+    int cards_seen;
+    int total_cards;
+} CountTracker;
+
+typedef struct {
+    long rounds;
+    double total_result;          // Sum of round results, in units of the initial bet
+    double total_result_squared;  // Sum of squared round results
+} CountBucket;
+
+// Round outcomes bucketed by the count at the start of the round: the true
+// count for a balanced system, the running count for an unbalanced one
+
+typedef struct {
+    CountBucket buckets[COUNT_NUM_BUCKETS];
+} CountTable;
+
+void count_system_hi_lo(CountSystem* system);
+
+int count_system_num_builtin(void);
+
+void count_system_builtin(int index, CountSystem* system);
+
+bool count_system_by_name(const char* name, CountSystem* system);
+
+bool count_system_is_balanced(const CountSystem* system);
+
+// Unbalanced systems start below zero so the count passes the same point,
+// the pivot, at the same edge whatever the number of decks: IRC = -(tags per
+// deck) x (decks - 1), as KO starts at 4 - 4 x decks
+int count_system_initial_count(const CountSystem* system, int num_decks);
+
+int count_rank_index(int card);
+
+void count_tracker_init(CountTracker* tracker, const CountSystem* systems, int num_systems, int num_decks);
+
+void count_tracker_reset(CountTracker* tracker);
+
+void count_tracker_observe(CountTracker* tracker, int card);
+
+int count_tracker_running_count(CountTracker* tracker, int system);
+
+double count_tracker_true_count(CountTracker* tracker, int system);
+
+// The count system's buckets, bet ramp and wonging go by
+double count_tracker_index(CountTracker* tracker, int system);
+
+int count_tracker_bucket(CountTracker* tracker, int system);
+
+void count_tracker_buckets(CountTracker* tracker, int* buckets);
+
+int count_bucket_for_true_count(double true_count);
+
+int count_bucket_true_count(int bucket);
+
+void count_table_record(CountTable* table, int bucket, double result);
+
+void count_table_add(CountTable* total, const CountTable* table);
+
+double count_bucket_ev(const CountBucket* bucket);
+
+double count_bucket_variance(const CountBucket* bucket);
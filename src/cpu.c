@@ -0,0 +1,60 @@
+#include "cpu.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CPU_LEVEL_UNSET -1
+#define CPU_LEVEL_ENV "BLACKJACK_CPU"  // scalar, avx2 or avx512: cap the level, e.g. to compare kernels
+
+static const char* level_names[CPU_NUM_LEVELS] = { "scalar", "avx2", "avx512" };
+
+static atomic_int selected_level = CPU_LEVEL_UNSET;
+
+// The best level this machine runs, from CPUID
+CpuLevel cpu_detect(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return CPU_LEVEL_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return CPU_LEVEL_AVX2;
+    }
+#endif
+    return CPU_LEVEL_SCALAR;
+}
+
+static CpuLevel capped_level(CpuLevel level) {
+    CpuLevel detected = cpu_detect();
+    return level < detected ? level : detected;
+}
+
+// Decided on first use: the detected level, lowered by BLACKJACK_CPU if set
+CpuLevel cpu_level(void) {
+    int level = atomic_load_explicit(&selected_level, memory_order_relaxed);
+    if (level != CPU_LEVEL_UNSET) {
+        return (CpuLevel)level;
+    }
+
+    level = cpu_detect();
+    const char* requested = getenv(CPU_LEVEL_ENV);
+    if (requested != NULL) {
+        for (int l = 0; l < CPU_NUM_LEVELS; l++) {
+            if (strcmp(requested, level_names[l]) == 0) {
+                level = capped_level((CpuLevel)l);
+            }
+        }
+    }
+
+    atomic_store_explicit(&selected_level, level, memory_order_relaxed);
+    return (CpuLevel)level;
+}
+
+// Never above what the machine supports
+void cpu_set_level(CpuLevel level) {
+    atomic_store_explicit(&selected_level, capped_level(level), memory_order_relaxed);
+}
+
+const char* cpu_level_name(CpuLevel level) {
+    return level >= 0 && level < CPU_NUM_LEVELS ? level_names[level] : "unknown";
+}
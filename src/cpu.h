@@ -0,0 +1,18 @@
+#pragma once
+
+// Instruction set levels the hot kernels are compiled for. Every level's code
+// is in the binary; cpu_level() picks the one to run.
+typedef enum {
+    CPU_LEVEL_SCALAR,
+    CPU_LEVEL_AVX2,
+    CPU_LEVEL_AVX512,
+    CPU_NUM_LEVELS
+} CpuLevel;
+
+CpuLevel cpu_detect(void);
+
+CpuLevel cpu_level(void);
+
+void cpu_set_level(CpuLevel level);
+
+const char* cpu_level_name(CpuLevel level);
@@ -1,4 +1,5 @@
 #include "dealer.h"
+#include "card.h"
 
 bool dealer_should_hit(Hand* hand, Rules* rules) {
     int hand_value = hand_get_value(hand);
@@ -11,4 +12,58 @@ bool dealer_should_hit(Hand* hand, Rules* rules) {
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+// A hard state never holds an ace worth 11, so an ace only makes a hand soft
+// when it can count 11 without busting; a soft hand turns hard when 11 would bust
+static int next_state(int state, int rank) {
+    bool soft = state >= DEALER_STATE_SOFT;
+    int hard_total = soft ? state - DEALER_STATE_SOFT - 10 : state;
+    hard_total += rank + 1;
+
+    if (hard_total > 21) {
+        return DEALER_STATE_BUST;
+    }
+    if ((soft || rank == 0) && hard_total <= 11) {
+        return DEALER_STATE_SOFT + hard_total + 10;
+    }
+    return hard_total;
+}
+
+void dealer_table_init(DealerTable* table, Rules* rules) {
+    for (int state = 0; state < DEALER_NUM_STATES; state++) {
+        bool bust = state == DEALER_STATE_BUST;
+        bool soft = !bust && state >= DEALER_STATE_SOFT;
+        int total = bust ? DEALER_BUST_TOTAL : soft ? state - DEALER_STATE_SOFT : state;
+
+        table->total[state] = (int8_t)total;
+        table->stands[state] = bust || total > 17 || (total == 17 && !(soft && rules->dealer_hits_soft_17));
+        for (int rank = 0; rank < DEALER_NUM_RANKS; rank++) {
+            table->next[state][rank] = bust ? DEALER_STATE_BUST : (int8_t)next_state(state, rank);
+        }
+    }
+}
+
+int dealer_rank_index(int card) {
+    int rank = card_rank(card);
+    return rank < DEALER_NUM_RANKS ? rank : DEALER_NUM_RANKS - 1;
+}
+
+int dealer_hand_state(const DealerTable* table, Hand* hand) {
+    int state = 0;
+    for (int i = 0; i < hand->num_cards; i++) {
+        state = table->next[state][dealer_rank_index(hand->cards[i])];
+    }
+    return state;
+}
+
+// Draws to a standing state and returns the final total
+int dealer_play(const DealerTable* table, Hand* hand, Deck* shoe) {
+    int state = dealer_hand_state(table, hand);
+    while (!table->stands[state]) {
+        int card = deck_deal(shoe);
+        hand_add_card(hand, card);
+        state = table->next[state][dealer_rank_index(card)];
+    }
+    return table->total[state];
+}
@@ -1,5 +1,34 @@
+#pragma once
+
 #include <stdbool.h>
+#include <stdint.h>
 #include "hand.h"
 #include "rules.h"
+#include "deck.h"
+
+#define DEALER_NUM_TOTALS 22                            // 0..21; anything over is the bust state
+#define DEALER_STATE_SOFT DEALER_NUM_TOTALS             // Soft states follow the hard ones
+#define DEALER_STATE_BUST (2 * DEALER_NUM_TOTALS)
+#define DEALER_NUM_STATES (DEALER_STATE_BUST + 1)
+#define DEALER_NUM_RANKS 10                             // A, 2, ..., 9, T
+#define DEALER_BUST_TOTAL 22
+
+// The dealer as a state machine over (total, soft). A hand starts in state 0,
+// each card moves it to next[state][rank], and it draws until it reaches a
+// state that stands. Built once per rule set, so playing the dealer needs no
+// hand_get_value() or hand_is_soft() calls.
+typedef struct {
+    int8_t next[DEALER_NUM_STATES][DEALER_NUM_RANKS];
+    int8_t total[DEALER_NUM_STATES];                    // DEALER_BUST_TOTAL once bust
+    bool stands[DEALER_NUM_STATES];                     // Terminal: stood or bust
+} DealerTable;
+
+bool dealer_should_hit(Hand* hand, Rules* rules);
+
+void dealer_table_init(DealerTable* table, Rules* rules);
+
+int dealer_rank_index(int card);
+
+int dealer_hand_state(const DealerTable* table, Hand* hand);
 
-bool dealer_should_hit(Hand* hand, Rules* rules);
\ No newline at end of file
+int dealer_play(const DealerTable* table, Hand* hand, Deck* shoe);
@@ -1,65 +1,365 @@
 #include "deck.h"
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define NUM_CARDS_PER_DECK 52
-static int rng_state = 123456789;  // Seed value
+#define NUM_CARDS_PER_RANK 4    // Per deck; the ten rank has four of each of T, J, Q, K
+#define NUM_RANKS_PER_SUIT 13
+#define TEN_RANK 9
 
-static inline int xorshift32(void) {
-    int x = rng_state;
-    x ^= x << 13;
-    x ^= x >> 17;
-    x ^= x << 5;
-    rng_state = x;
-    return x;
+typedef int16_t RankLanes __attribute__((vector_size(DECK_RANK_LANES * sizeof(int16_t))));
+
+static const RankLanes lane_ids = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+// Decks made by deck_init draw their shoes from the thread's default seed,
+// each claiming its own block of shoe indices so back-to-back simulations
+// don't repeat each other
+static _Thread_local uint64_t default_seed = 123456789;
+static _Thread_local uint64_t next_shoe_block = 0;
+
+static inline int random_range(Deck* deck, int max) {
+    return (int)rng_range(&deck->rng, (uint32_t)max);
+}
+
+// Every shoe is shuffled from this order, so its cards depend on nothing
+// but its own draws
+static void order_cards(Deck* deck) {
+    for (int i = 0; i < deck->total_cards; i++) {
+        deck->cards[i] = i % NUM_CARDS_PER_DECK;
+    }
+}
+
+static void fill_cards(Deck* deck) {
+    deck->cards = malloc(deck->total_cards * sizeof(int));
+    deck->lazy_swaps = malloc(deck->total_cards * sizeof(int));
+    order_cards(deck);
 }
 
-// To get a number in a range [0, max) without modulo bias
-int random_range(int max) {
-    if (max <= 0) return 0;
+static void free_cards(Deck* deck) {
+    free(deck->cards);
+    free(deck->lazy_swaps);
+    deck->cards = NULL;
+    deck->lazy_swaps = NULL;
+}
+
+static void fill_composition(Deck* deck) {
+    int cumulative = 0;
+    for (int r = 0; r < DECK_RANK_LANES; r++) {
+        if (r < DECK_NUM_RANKS) {
+            cumulative += NUM_CARDS_PER_RANK * deck->num_decks * (r == TEN_RANK ? 4 : 1);
+            deck->cumulative_counts[r] = (int16_t)cumulative;
+        } else {
+            deck->cumulative_counts[r] = INT16_MAX;  // Padding lanes never match a draw
+        }
+    }
+}
+
+// Walker/Vose alias table in exact integer arithmetic. Each of the n columns
+// holds total_weight units; column r keeps rank r for the first
+// threshold[r] units and gives the rest to alias[r].
+static void build_alias_table(Deck* deck) {
+    int scaled[DECK_NUM_RANKS];
+    int small[DECK_NUM_RANKS];
+    int large[DECK_NUM_RANKS];
+    int num_small = 0;
+    int num_large = 0;
+    int total = 0;
+
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        total += deck->rank_weights[r];
+    }
+    deck->alias_total_weight = total;
+
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        scaled[r] = deck->rank_weights[r] * DECK_NUM_RANKS;
+        deck->alias[r] = r;
+        if (scaled[r] < total) {
+            small[num_small++] = r;
+        } else {
+            large[num_large++] = r;
+        }
+    }
+
+    while (num_small > 0 && num_large > 0) {
+        int s = small[--num_small];
+        int l = large[--num_large];
+        deck->alias_threshold[s] = scaled[s];
+        deck->alias[s] = l;
+
+        scaled[l] -= total - scaled[s];
+        if (scaled[l] < total) {
+            small[num_small++] = l;
+        } else {
+            large[num_large++] = l;
+        }
+    }
+
+    // Whatever is left fills its column exactly
+    while (num_large > 0) {
+        deck->alias_threshold[large[--num_large]] = total;
+    }
+    while (num_small > 0) {
+        deck->alias_threshold[small[--num_small]] = total;
+    }
+}
 
-    // Use rejection sampling to avoid modulo bias
-    int limit = 0x7FFFFFFF - (0x7FFFFFFF % max);  // Largest multiple of max
-    int value;
+static void fill_standard_weights(Deck* deck) {
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        deck->rank_weights[r] = r == TEN_RANK ? 4 : 1;
+    }
+    build_alias_table(deck);
+}
 
-    do {
-        value = xorshift32() & 0x7FFFFFFF;  // Force positive by masking sign bit
-    } while (value >= limit);
+// The alias table scales weights by DECK_NUM_RANKS in int arithmetic, and
+// a draw covers DECK_NUM_RANKS x total, so the total has to stay under
+// DECK_MAX_RANK_WEIGHT_TOTAL
+bool deck_set_rank_weights(Deck* deck, const int* rank_weights) {
+    long long total = 0;
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        if (rank_weights[r] < 0) {
+            return false;
+        }
+        total += rank_weights[r];
+    }
+    if (total == 0 || total > DECK_MAX_RANK_WEIGHT_TOTAL) {
+        return false;
+    }
 
-    return value % max;
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        deck->rank_weights[r] = rank_weights[r];
+    }
+    build_alias_table(deck);
+    return true;
 }
 
 void deck_init(Deck* deck, int num_decks) {
+    deck_init_mode(deck, num_decks, DECK_SHUFFLE_FULL);
+}
+
+void deck_init_mode(Deck* deck, int num_decks, DeckMode mode) {
     deck->num_decks = num_decks;
     deck->total_cards = num_decks * NUM_CARDS_PER_DECK;
     deck->position = 0;
-    deck->cards = malloc(deck->total_cards * sizeof(int));
-    
-    for (int i = 0; i < deck->total_cards; i++) {
-        deck->cards[i] = i % NUM_CARDS_PER_DECK;
+    deck->mode = mode;
+    deck->cards = NULL;
+    deck->lazy_swaps = NULL;
+
+    fill_standard_weights(deck);
+    if (mode == DECK_COMPOSITION) {
+        fill_composition(deck);
+    } else if (mode != DECK_INFINITE) {
+        fill_cards(deck);
     }
+
+    deck_seed(deck, default_seed, next_shoe_block);
+    next_shoe_block += DECK_SHOES_PER_INIT;
 }
 
+static bool mode_has_cards(DeckMode mode) {
+    return mode == DECK_SHUFFLE_FULL || mode == DECK_SHUFFLE_LAZY;
+}
+
+// Switching between a card array and a card-free mode starts a fresh,
+// unshuffled shoe
+void deck_set_mode(Deck* deck, DeckMode mode) {
+    if (mode_has_cards(deck->mode) && !mode_has_cards(mode)) {
+        free_cards(deck);
+    } else if (!mode_has_cards(deck->mode) && mode_has_cards(mode)) {
+        fill_cards(deck);
+    } else if (mode_has_cards(mode) && mode != deck->mode) {
+        order_cards(deck);
+    }
+
+    if (mode == DECK_COMPOSITION && deck->mode != DECK_COMPOSITION) {
+        fill_composition(deck);
+    }
+    if (mode != deck->mode) {
+        deck->position = 0;
+    }
+
+    deck->mode = mode;
+}
+
+// Draw a rank with probability proportional to its undealt count. The
+// cumulative counts live in one vector, so finding the rank is a single
+// compare against the target and taking the card is a single masked add.
+static int composition_deal(Deck* deck) {
+    RankLanes cumulative;
+    memcpy(&cumulative, deck->cumulative_counts, sizeof(cumulative));
+
+    RankLanes target = (RankLanes){0} + (int16_t)random_range(deck, deck->total_cards - deck->position);
+    RankLanes before = cumulative <= target;  // -1 for every rank entirely below the draw
+    int rank = 0;
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        rank -= before[r];
+    }
+
+    RankLanes rank_lanes = (RankLanes){0} + (int16_t)rank;
+    cumulative += (lane_ids >= rank_lanes) & (lane_ids < DECK_NUM_RANKS);
+    memcpy(deck->cumulative_counts, &cumulative, sizeof(cumulative));
+
+    return rank;  // Card rank r of the first suit: A, 2, ..., 9, T
+}
+
+// O(1) draw from the alias table: one uniform number picks both the column
+// and the point within it
+static int infinite_deal(Deck* deck) {
+    int draw = random_range(deck, DECK_NUM_RANKS * deck->alias_total_weight);
+    int column = draw / deck->alias_total_weight;
+    int offset = draw - column * deck->alias_total_weight;
+
+    return offset < deck->alias_threshold[column] ? column : deck->alias[column];
+}
+
+void deck_composition(Deck* deck, int* rank_counts) {
+    if (deck->mode == DECK_INFINITE) {
+        for (int r = 0; r < DECK_NUM_RANKS; r++) {
+            rank_counts[r] = deck->rank_weights[r];
+        }
+        return;
+    }
+
+    if (deck->mode == DECK_COMPOSITION) {
+        int previous = 0;
+        for (int r = 0; r < DECK_NUM_RANKS; r++) {
+            rank_counts[r] = deck->cumulative_counts[r] - previous;
+            previous = deck->cumulative_counts[r];
+        }
+        return;
+    }
+
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        rank_counts[r] = 0;
+    }
+    for (int i = deck->position; i < deck->total_cards; i++) {
+        int rank = deck->cards[i] % NUM_RANKS_PER_SUIT;
+        rank_counts[rank < TEN_RANK ? rank : TEN_RANK]++;
+    }
+}
+
+// Every shuffle starts a new shoe whose cards depend only on its (seed,
+// shoe_index) coordinates. The full shuffle runs Fisher-Yates forwards, taking
+// the same draws a lazy shoe takes card by card, so both modes deal identical
+// shoes from the same coordinates.
 void deck_shuffle(Deck* deck) {
-    for (int i = deck->total_cards - 1; i > 0; i--) {
-        int j = random_range(i);
-        int swap = deck->cards[i];
-        deck->cards[i] = deck->cards[j];
-        deck->cards[j] = swap;
+    deck->shoe_index = deck->next_shoe++;
+    rng_stream_init(&deck->rng, deck->seed, deck->shoe_index);
+
+    // Lazy shoes randomize each card as it's dealt, so a shuffle only has to
+    // undo the swaps of the cards dealt since the last one
+    if (deck->mode == DECK_COMPOSITION) {
+        fill_composition(deck);
+    } else if (deck->mode == DECK_SHUFFLE_LAZY) {
+        for (int i = deck->position - 1; i >= 0; i--) {
+            int j = deck->lazy_swaps[i];
+            int swap = deck->cards[i];
+            deck->cards[i] = deck->cards[j];
+            deck->cards[j] = swap;
+        }
+    } else if (deck->mode == DECK_SHUFFLE_FULL) {
+        order_cards(deck);
+        for (int i = 0; i < deck->total_cards - 1; i++) {
+            int j = i + random_range(deck, deck->total_cards - i);
+            int swap = deck->cards[i];
+            deck->cards[i] = deck->cards[j];
+            deck->cards[j] = swap;
+        }
     }
 
     deck->position = 0;
 }
 
 int deck_deal(Deck* deck) {
+    // Nothing is ever used up, so the shoe never reaches its cut card
+    if (deck->mode == DECK_INFINITE) {
+        return infinite_deal(deck);
+    }
+
+    if (deck->position >= deck->total_cards) {
+        deck_shuffle(deck);  // Shoe exhausted mid-round: reshuffle rather than read past the end
+    }
+
+    if (deck->mode == DECK_COMPOSITION) {
+        int rank = composition_deal(deck);
+        deck->position++;
+        return rank;
+    }
+
+    if (deck->mode == DECK_SHUFFLE_LAZY) {
+        // One forward Fisher-Yates step: swap a random undealt card into place
+        int j = deck->position + random_range(deck, deck->total_cards - deck->position);
+        deck->lazy_swaps[deck->position] = j;
+        int swap = deck->cards[deck->position];
+        deck->cards[deck->position] = deck->cards[j];
+        deck->cards[j] = swap;
+    }
+
     int dealt_card = deck->cards[deck->position];
     deck->position++;
     return dealt_card;
 }
 
 void deck_destroy(Deck* deck) {
-    free(deck->cards);
+    free_cards(deck);
+}
+
+// The next deck_shuffle deals shoe (seed, first_shoe), then first_shoe + 1, ...
+void deck_seed(Deck* deck, uint64_t seed, uint64_t first_shoe) {
+    deck->seed = seed;
+    deck->shoe_index = first_shoe;
+    deck->next_shoe = first_shoe;
+    rng_stream_init(&deck->rng, seed, first_shoe);
 }
 
+// Regenerate shoe (seed, shoe_index) and deal up to `position`, so the next
+// deck_deal returns the card a simulation saw at that point of that shoe
+void deck_replay(Deck* deck, uint64_t seed, uint64_t shoe_index, int position) {
+    deck_seed(deck, seed, shoe_index);
+    deck_shuffle(deck);
+    for (int i = 0; i < position; i++) {
+        deck_deal(deck);
+    }
+}
+
+void deck_mark(const Deck* deck, DeckMark* mark) {
+    mark->shoe_index = deck->shoe_index;
+    mark->position = deck->position;
+    mark->rng_word = rng_tell(&deck->rng);
+    memcpy(mark->cumulative_counts, deck->cumulative_counts, sizeof(mark->cumulative_counts));
+}
+
+// O(cards dealt since the mark). A shoe reshuffled since is dealt again from
+// the top, the one case that costs the whole position; infinite shoes never
+// move position, so the stream seek below is what puts them back.
+void deck_rewind(Deck* deck, const DeckMark* mark) {
+    if (deck->shoe_index != mark->shoe_index) {
+        deck_replay(deck, deck->seed, mark->shoe_index, mark->position);
+    } else if (deck->mode == DECK_SHUFFLE_LAZY) {
+        for (int i = deck->position - 1; i >= mark->position; i--) {
+            int j = deck->lazy_swaps[i];
+            int swap = deck->cards[i];
+            deck->cards[i] = deck->cards[j];
+            deck->cards[j] = swap;
+        }
+    } else if (deck->mode == DECK_COMPOSITION) {
+        memcpy(deck->cumulative_counts, mark->cumulative_counts, sizeof(mark->cumulative_counts));
+    }
+    deck->position = mark->position;
+    rng_seek(&deck->rng, mark->rng_word);
+}
+
+// Cards dealt from here on come from branch's own stretch of the shoe's
+// stream: different for each branch, the same every time for one. Rewinding
+// to a mark leaves the branch. A full shuffle has already drawn the whole
+// shoe, so branching it changes nothing.
+void deck_branch(Deck* deck, uint64_t branch) {
+    rng_seek(&deck->rng, (branch + 1) * DECK_BRANCH_WORDS);
+}
+
+// Resets the thread's default seed: decks initialized after this on the same
+// thread get the same shoes in the same order
 void deck_set_rng_seed(int seed) {
-    rng_state = seed;
-}
\ No newline at end of file
+    default_seed = (uint32_t)seed;
+    next_shoe_block = 0;
+}
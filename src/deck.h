@@ -1,18 +1,76 @@
 #pragma once
 
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "rng.h"
+
+#define DECK_NUM_RANKS 10    // A, 2, ..., 9, T (J/Q/K are dealt as T in composition mode)
+#define DECK_RANK_LANES 16   // Rank counts padded to one 256-bit vector
+#define DECK_SHOES_PER_INIT (1ull << 32)  // Shoe indices each deck_init claims from the thread's default seed
+#define DECK_MAX_RANK_WEIGHT_TOTAL (INT_MAX / DECK_NUM_RANKS)  // Infinite mode: sum of rank weights
+#define DECK_BRANCH_WORDS (1ull << 40)    // Stretch of a shoe's random stream each deck_branch gets to itself
+
+typedef enum {
+    DECK_SHUFFLE_FULL,  // deck_shuffle permutes the whole shoe up front
+    DECK_SHUFFLE_LAZY,  // deck_deal does one Fisher-Yates step per card; same distribution
+    DECK_COMPOSITION,   // No card array: deck_deal samples a rank from the remaining counts
+    DECK_INFINITE       // No card array, no depletion: i.i.d. ranks from an alias table
+} DeckMode;
+
 typedef struct {
     int* cards;
+    int* lazy_swaps;                             // Lazy mode: slot swapped into each dealt position, undone by deck_shuffle
     int num_decks;
     int total_cards;
     int position;
+    DeckMode mode;
+    int16_t cumulative_counts[DECK_RANK_LANES];  // Composition mode: undealt cards of rank <= i
+    int rank_weights[DECK_NUM_RANKS];            // Infinite mode: relative rank frequencies
+    int alias_total_weight;                      // Infinite mode: sum of rank_weights
+    int alias_threshold[DECK_NUM_RANKS];         // Infinite mode: keep column r if draw < threshold, out of total weight
+    int alias[DECK_NUM_RANKS];                   // Infinite mode: otherwise deal this rank
+    uint64_t seed;                               // The current shoe is (seed, shoe_index)...
+    uint64_t shoe_index;
+    uint64_t next_shoe;                          // ...and deck_shuffle moves on to (seed, next_shoe)
+    RngStream rng;                               // Every draw for the current shoe
 } Deck;
 
+// Where a shoe stood, without copying it: rewinding undoes the lazy swaps
+// dealt since and moves the random stream back, so the same cards come again
+typedef struct {
+    uint64_t shoe_index;
+    int position;
+    uint64_t rng_word;                           // rng_tell() of the shoe's stream
+    int16_t cumulative_counts[DECK_RANK_LANES];  // Composition mode
+} DeckMark;
+
 void deck_init(Deck* deck, int num_decks);
 
+void deck_init_mode(Deck* deck, int num_decks, DeckMode mode);
+
+void deck_set_mode(Deck* deck, DeckMode mode);
+
+void deck_composition(Deck* deck, int* rank_counts);
+
+// false (and the weights unchanged) if any is negative or they total 0 or
+// more than DECK_MAX_RANK_WEIGHT_TOTAL
+bool deck_set_rank_weights(Deck* deck, const int* rank_weights);
+
 void deck_shuffle(Deck* deck);
 
 int deck_deal(Deck* deck);
 
 void deck_destroy(Deck* deck);
 
+void deck_seed(Deck* deck, uint64_t seed, uint64_t first_shoe);
+
+void deck_replay(Deck* deck, uint64_t seed, uint64_t shoe_index, int position);
+
+void deck_mark(const Deck* deck, DeckMark* mark);
+
+void deck_rewind(Deck* deck, const DeckMark* mark);
+
+void deck_branch(Deck* deck, uint64_t branch);
+
 void deck_set_rng_seed(int seed);
\ No newline at end of file
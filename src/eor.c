@@ -0,0 +1,460 @@
+#include "eor.h"
+#include "card.h"
+#include "dealer.h"
+#include "hand.h"
+#include <math.h>
+#include <string.h>
+
+#define RANK_ACE 0
+#define RANK_TEN 9
+#define CARDS_PER_RANK_PER_DECK 4
+#define TENS_PER_DECK 16
+#define NUM_CARDS_PER_DECK 52
+
+#define NUM_DEALER_OUTCOMES 7  // 17, 18, 19, 20, 21, bust, natural
+#define OUTCOME_BUST 5
+#define OUTCOME_NATURAL 6
+#define MAX_HAND_TOTAL 32
+#define BLACKJACK_VAL 21
+#define SQRT_TWO_PI 2.5066282746310002
+#define SQRT_TWO 1.4142135623730951
+#define EOR_DEPTH_STEPS 16        // Depths averaged over for playing efficiency
+
+// Analytic EV of a fixed strategy for one dealer upcard. Draws are treated as
+// independent with the probabilities of the given composition (the usual
+// infinite-deck approximation for effects of removal). Decisions go through
+// get_basic_strategy_action() and dealer_should_hit() on real Hand structs,
+// so the numbers follow the same Rules handling as the simulator. Split hands
+// are not resplit.
+typedef struct {
+    Rules* rules;
+    BasicStrategy* strategy;
+    double probability[COUNT_NUM_RANKS];
+    int upcard;
+    double natural_probability;             // Dealer blackjack behind this upcard
+    double dealer[NUM_DEALER_OUTCOMES];     // Given no natural when the dealer peeks
+    double dealer_memo[MAX_HAND_TOTAL][2][NUM_DEALER_OUTCOMES];
+    bool dealer_memo_valid[MAX_HAND_TOTAL][2];
+    double hand_memo[MAX_HAND_TOTAL][2];    // Hands of 3+ cards depend only on total/softness
+    bool hand_memo_valid[MAX_HAND_TOTAL][2];
+} EvContext;
+
+static void dealer_outcomes(EvContext* ctx, Hand* hand, double* outcomes) {
+    int value = hand_get_value(hand);
+    memset(outcomes, 0, sizeof(double) * NUM_DEALER_OUTCOMES);
+
+    if (!dealer_should_hit(hand, ctx->rules)) {
+        outcomes[value > BLACKJACK_VAL ? OUTCOME_BUST : value - 17] = 1.0;
+        return;
+    }
+
+    int soft = hand_is_soft(hand) ? 1 : 0;
+    if (ctx->dealer_memo_valid[value][soft]) {
+        memcpy(outcomes, ctx->dealer_memo[value][soft], sizeof(double) * NUM_DEALER_OUTCOMES);
+        return;
+    }
+
+    double next[NUM_DEALER_OUTCOMES];
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        hand_add_card(hand, r);
+        dealer_outcomes(ctx, hand, next);
+        hand_pop_card(hand);
+
+        for (int o = 0; o < NUM_DEALER_OUTCOMES; o++) {
+            outcomes[o] += ctx->probability[r] * next[o];
+        }
+    }
+
+    memcpy(ctx->dealer_memo[value][soft], outcomes, sizeof(double) * NUM_DEALER_OUTCOMES);
+    ctx->dealer_memo_valid[value][soft] = true;
+}
+
+static void context_init(EvContext* ctx, Rules* rules, BasicStrategy* strategy, const double* probability, int upcard) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->rules = rules;
+    ctx->strategy = strategy;
+    ctx->upcard = upcard;
+    memcpy(ctx->probability, probability, sizeof(ctx->probability));
+
+    if (upcard == RANK_ACE) {
+        ctx->natural_probability = probability[RANK_TEN];
+    } else if (upcard == RANK_TEN) {
+        ctx->natural_probability = probability[RANK_ACE];
+    }
+
+    Hand hand;
+    hand_init(&hand);
+    hand_add_card(&hand, upcard);
+
+    double next[NUM_DEALER_OUTCOMES];
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        hand_add_card(&hand, r);
+        if (hand_is_blackjack(&hand)) {
+            ctx->dealer[OUTCOME_NATURAL] += probability[r];
+        } else {
+            dealer_outcomes(ctx, &hand, next);
+            for (int o = 0; o < NUM_DEALER_OUTCOMES; o++) {
+                ctx->dealer[o] += probability[r] * next[o];
+            }
+        }
+        hand_pop_card(&hand);
+    }
+    hand_destroy(&hand);
+
+    // With a peek, player decisions are only ever made once the natural is ruled out
+    if (rules->dealer_peeks_blackjack && ctx->natural_probability > 0) {
+        ctx->dealer[OUTCOME_NATURAL] = 0;
+        for (int o = 0; o < NUM_DEALER_OUTCOMES; o++) {
+            ctx->dealer[o] /= 1.0 - ctx->natural_probability;
+        }
+    }
+}
+
+static double stand_ev(EvContext* ctx, int total) {
+    if (total > BLACKJACK_VAL) {
+        return -1.0;
+    }
+
+    double ev = ctx->dealer[OUTCOME_BUST] - ctx->dealer[OUTCOME_NATURAL];
+    for (int o = 0; o < OUTCOME_BUST; o++) {
+        int dealer_total = 17 + o;
+        if (total > dealer_total) {
+            ev += ctx->dealer[o];
+        } else if (total < dealer_total) {
+            ev -= ctx->dealer[o];
+        }
+    }
+
+    return ev;
+}
+
+static double hand_ev(EvContext* ctx, Hand* hand, bool can_split, bool can_double, bool can_surrender);
+
+static double split_hand_ev(EvContext* ctx, int pair_card) {
+    Hand hand;
+    hand_init(&hand);
+    hand_add_card(&hand, pair_card);
+
+    double ev = 0.0;
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        hand_add_card(&hand, r);
+        if (pair_card == RANK_ACE && !ctx->rules->can_hit_split_aces) {
+            ev += ctx->probability[r] * stand_ev(ctx, hand_get_value(&hand));
+        } else {
+            ev += ctx->probability[r] * hand_ev(ctx, &hand, false, ctx->rules->double_after_split, false);
+        }
+        hand_pop_card(&hand);
+    }
+
+    hand_destroy(&hand);
+    return ev;
+}
+
+static double action_ev(EvContext* ctx, Hand* hand, PlayerAction action) {
+    double ev = 0.0;
+
+    switch (action) {
+        case STAND:
+            return stand_ev(ctx, hand_get_value(hand));
+        case HIT:
+            for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+                hand_add_card(hand, r);
+                ev += ctx->probability[r] * hand_ev(ctx, hand, false, false, false);
+                hand_pop_card(hand);
+            }
+            return ev;
+        case DOUBLE:
+            for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+                hand_add_card(hand, r);
+                ev += ctx->probability[r] * stand_ev(ctx, hand_get_value(hand));
+                hand_pop_card(hand);
+            }
+            return 2.0 * ev;
+        case SPLIT:
+            return 2.0 * split_hand_ev(ctx, count_rank_index(hand->cards[0]));
+        case SURRENDER:
+            return -0.5;
+        default:
+            return 0.0;
+    }
+}
+
+static double hand_ev(EvContext* ctx, Hand* hand, bool can_split, bool can_double, bool can_surrender) {
+    int value = hand_get_value(hand);
+    if (value > BLACKJACK_VAL) {
+        return -1.0;
+    }
+
+    bool memoizable = hand->num_cards >= 3;
+    int soft = hand_is_soft(hand) ? 1 : 0;
+    if (memoizable && ctx->hand_memo_valid[value][soft]) {
+        return ctx->hand_memo[value][soft];
+    }
+
+    PlayerAction action = get_basic_strategy_action(hand, ctx->upcard, ctx->rules, ctx->strategy,
+                                                    can_split, can_double, can_surrender);
+    double ev = action_ev(ctx, hand, action);
+
+    if (memoizable) {
+        ctx->hand_memo[value][soft] = ev;
+        ctx->hand_memo_valid[value][soft] = true;
+    }
+
+    return ev;
+}
+
+static bool action_is_legal(Rules* rules, Hand* hand, PlayerAction action) {
+    switch (action) {
+        case DOUBLE: {
+            int value = hand_get_value(hand);
+            return rules->double_any_two_cards || (value >= 9 && value <= 11);
+        }
+        case SPLIT:
+            return rules->max_splits > 0 && hand_can_split(hand);
+        case SURRENDER:
+            return rules->late_surrender_allowed;
+        default:
+            return true;
+    }
+}
+
+// EV of the player's opening two cards against this upcard, including the
+// dealer-natural outcomes the peek rules out of the playing decision.
+static double opening_hand_ev(EvContext* ctx, Hand* hand) {
+    double natural = ctx->natural_probability;
+    bool peek = ctx->rules->dealer_peeks_blackjack;
+
+    if (hand_is_blackjack(hand)) {
+        return (1.0 - natural) * ctx->rules->blackjack_payout;
+    }
+
+    double ev = hand_ev(ctx, hand, ctx->rules->max_splits > 0, true, true);
+    if (peek) {
+        return natural * -1.0 + (1.0 - natural) * ev;
+    }
+
+    return ev;
+}
+
+static double composition_ev(Rules* rules, BasicStrategy* strategy, const double* probability) {
+    EvContext ctx;
+    Hand hand;
+    hand_init(&hand);
+    double ev = 0.0;
+
+    for (int up = 0; up < COUNT_NUM_RANKS; up++) {
+        context_init(&ctx, rules, strategy, probability, up);
+
+        for (int first = 0; first < COUNT_NUM_RANKS; first++) {
+            for (int second = 0; second < COUNT_NUM_RANKS; second++) {
+                hand.num_cards = 0;
+                hand_add_card(&hand, first);
+                hand_add_card(&hand, second);
+                ev += probability[up] * probability[first] * probability[second] * opening_hand_ev(&ctx, &hand);
+            }
+        }
+    }
+
+    hand_destroy(&hand);
+    return ev;
+}
+
+static void composition_probabilities(const double* composition, double* probability) {
+    double total = 0.0;
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        total += composition[r];
+    }
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        probability[r] = composition[r] / total;
+    }
+}
+
+static double insurance_ev(Rules* rules, const double* probability) {
+    return rules->insurance_payout * probability[RANK_TEN] - (1.0 - probability[RANK_TEN]);
+}
+
+void eor_shoe_composition(int num_decks, double* composition) {
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        composition[r] = (double)num_decks * CARDS_PER_RANK_PER_DECK;
+    }
+    composition[RANK_TEN] = (double)num_decks * TENS_PER_DECK;
+}
+
+double eor_strategy_ev(Rules* rules, BasicStrategy* strategy, const double* composition) {
+    double probability[COUNT_NUM_RANKS];
+    composition_probabilities(composition, probability);
+    return composition_ev(rules, strategy, probability);
+}
+
+// Gap between the strategy's action and the best other legal action, for
+// every opening decision, at one shoe composition.
+static void decision_gaps(Rules* rules, BasicStrategy* strategy, const double* probability,
+                          EorTable* table, bool choose_alternatives, double* gaps) {
+    static const PlayerAction actions[] = { STAND, HIT, DOUBLE, SPLIT, SURRENDER };
+    EvContext ctx;
+    Hand hand;
+    hand_init(&hand);
+    int d = 0;
+
+    for (int up = 0; up < COUNT_NUM_RANKS; up++) {
+        context_init(&ctx, rules, strategy, probability, up);
+
+        for (int first = 0; first < COUNT_NUM_RANKS; first++) {
+            for (int second = first; second < COUNT_NUM_RANKS; second++) {
+                hand.num_cards = 0;
+                hand_add_card(&hand, first);
+                hand_add_card(&hand, second);
+                if (hand_is_blackjack(&hand)) {
+                    continue;
+                }
+
+                EorDecision* decision = &table->decisions[d];
+                if (choose_alternatives) {
+                    decision->first_card = first;
+                    decision->second_card = second;
+                    decision->upcard = up;
+                    decision->strategy_action = get_basic_strategy_action(&hand, up, rules, strategy, rules->max_splits > 0, true, true);
+                    decision->probability = probability[up] * probability[first] * probability[second] *
+                                            (first == second ? 1.0 : 2.0) * (1.0 - ctx.natural_probability);
+
+                    double best_alternative = -INFINITY;
+                    decision->alternative_action = decision->strategy_action;
+                    for (int a = 0; a < (int)(sizeof(actions) / sizeof(actions[0])); a++) {
+                        if (actions[a] == decision->strategy_action || !action_is_legal(rules, &hand, actions[a])) {
+                            continue;
+                        }
+                        double ev = action_ev(&ctx, &hand, actions[a]);
+                        if (ev > best_alternative) {
+                            best_alternative = ev;
+                            decision->alternative_action = actions[a];
+                        }
+                    }
+                }
+
+                gaps[d] = action_ev(&ctx, &hand, decision->strategy_action) -
+                          action_ev(&ctx, &hand, decision->alternative_action);
+                d++;
+            }
+        }
+    }
+
+    table->num_decisions = d;
+    hand_destroy(&hand);
+}
+
+void eor_compute(Rules* rules, BasicStrategy* strategy, EorTable* table) {
+    double composition[COUNT_NUM_RANKS];
+    double probability[COUNT_NUM_RANKS];
+    double base_gaps[EOR_MAX_DECISIONS];
+    double removed_gaps[EOR_MAX_DECISIONS];
+
+    eor_shoe_composition(rules->num_decks, composition);
+    composition_probabilities(composition, probability);
+
+    table->total_cards = (double)rules->num_decks * NUM_CARDS_PER_DECK;
+    table->cut_card_depth = rules->shoe_penetration * table->total_cards;
+    table->base_ev = composition_ev(rules, strategy, probability);
+    table->base_insurance_ev = insurance_ev(rules, probability);
+    memcpy(table->rank_weights, probability, sizeof(table->rank_weights));
+    decision_gaps(rules, strategy, probability, table, true, base_gaps);
+
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        double removed[COUNT_NUM_RANKS];
+        double removed_probability[COUNT_NUM_RANKS];
+        memcpy(removed, composition, sizeof(removed));
+        removed[r] -= 1.0;
+        composition_probabilities(removed, removed_probability);
+
+        table->eor[r] = composition_ev(rules, strategy, removed_probability) - table->base_ev;
+        table->insurance_eor[r] = insurance_ev(rules, removed_probability) - table->base_insurance_ev;
+
+        decision_gaps(rules, strategy, removed_probability, table, false, removed_gaps);
+        for (int d = 0; d < table->num_decisions; d++) {
+            table->decisions[d].eor[r] = removed_gaps[d] - base_gaps[d];
+        }
+    }
+
+    for (int d = 0; d < table->num_decisions; d++) {
+        table->decisions[d].gap = base_gaps[d];
+    }
+}
+
+// Pearson correlation of tags and effects, weighted by each rank's share of the shoe
+static double weighted_correlation(const double* weights, const int* tags, const double* effects) {
+    double mean_tag = 0.0;
+    double mean_effect = 0.0;
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        mean_tag += weights[r] * tags[r];
+        mean_effect += weights[r] * effects[r];
+    }
+
+    double covariance = 0.0;
+    double tag_variance = 0.0;
+    double effect_variance = 0.0;
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        double tag = tags[r] - mean_tag;
+        double effect = effects[r] - mean_effect;
+        covariance += weights[r] * tag * effect;
+        tag_variance += weights[r] * tag * tag;
+        effect_variance += weights[r] * effect * effect;
+    }
+
+    if (tag_variance <= 0 || effect_variance <= 0) {
+        return 0.0;
+    }
+
+    return covariance / sqrt(tag_variance * effect_variance);
+}
+
+// Expected gain from switching plays whenever a normally distributed gap
+// (mean gap, standard deviation spread) turns negative: E[max(0, -gap)].
+static double switching_gain(double gap, double spread) {
+    if (spread <= 0) {
+        return gap < 0 ? -gap : 0.0;
+    }
+
+    double z = gap / spread;
+    double density = exp(-0.5 * z * z) / SQRT_TWO_PI;
+    double tail = 0.5 * erfc(z / SQRT_TWO);
+    return spread * density - gap * tail;
+}
+
+void eor_evaluate_system(const EorTable* table, const CountSystem* system, CountSystemEfficiency* efficiency) {
+    efficiency->betting_correlation = weighted_correlation(table->rank_weights, system->tags, table->eor);
+    efficiency->insurance_correlation = weighted_correlation(table->rank_weights, system->tags, table->insurance_eor);
+
+    // Playing efficiency: share of the perfect-information gain from varying
+    // each opening decision that a count with this correlation captures. The
+    // gap's spread comes from sampling the cards seen so far out of the shoe,
+    // averaged over rounds dealt evenly from the top of the shoe to the cut.
+    double captured = 0.0;
+    double available = 0.0;
+
+    for (int d = 0; d < table->num_decisions; d++) {
+        const EorDecision* decision = &table->decisions[d];
+
+        double mean_eor = 0.0;
+        double mean_square_eor = 0.0;
+        for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+            mean_eor += table->rank_weights[r] * decision->eor[r];
+            mean_square_eor += table->rank_weights[r] * decision->eor[r] * decision->eor[r];
+        }
+        double variance = mean_square_eor - mean_eor * mean_eor;
+        if (variance <= 0) {
+            continue;
+        }
+
+        // Where the strategy's play is already off for the full shoe, playing
+        // the alternative every time gains this much without any count
+        double correlation = fabs(weighted_correlation(table->rank_weights, system->tags, decision->eor));
+        double uncounted = switching_gain(decision->gap, 0.0);
+        for (int i = 0; i < EOR_DEPTH_STEPS; i++) {
+            double cards_seen = table->cut_card_depth * (i + 0.5) / EOR_DEPTH_STEPS;
+            double spread = sqrt(variance * cards_seen * (table->total_cards - cards_seen) / (table->total_cards - 1));
+            captured += decision->probability * (switching_gain(decision->gap, correlation * spread) - uncounted);
+            available += decision->probability * (switching_gain(decision->gap, spread) - uncounted);
+        }
+    }
+
+    efficiency->playing_efficiency = available > 0 ? captured / available : 0.0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "rules.h"
+#include "strategy.h"
+#include "counting.h"
+
+// Opening two-card hands (either order) against each upcard
+#define EOR_MAX_DECISIONS (COUNT_NUM_RANKS * (COUNT_NUM_RANKS + 1) / 2 * COUNT_NUM_RANKS)
+
+// One first-action playing decision (player two-card hand vs dealer upcard)
+typedef struct {
+    int first_card;                    // Rank index, 0 = Ace ... 9 = Ten
+    int second_card;
+    int upcard;
+    PlayerAction strategy_action;      // What BasicStrategy plays
+    PlayerAction alternative_action;   // The closest other legal action
+    double probability;                // Chance of facing this decision in a round
+    double gap;                        // EV(strategy) - EV(alternative), full shoe
+    double eor[COUNT_NUM_RANKS];       // Change in gap from removing one card of each rank
+} EorDecision;
+
+typedef struct {
+    double base_ev;                          // Full-shoe EV of the strategy, per initial unit
+    double eor[COUNT_NUM_RANKS];             // Change in EV from removing one card of each rank
+    double base_insurance_ev;
+    double insurance_eor[COUNT_NUM_RANKS];
+    double rank_weights[COUNT_NUM_RANKS];    // Share of the shoe held by each rank
+    double cut_card_depth;                   // Cards dealt before the reshuffle
+    double total_cards;
+    int num_decisions;
+    EorDecision decisions[EOR_MAX_DECISIONS];
+} EorTable;
+
+typedef struct {
+    double betting_correlation;
+    double playing_efficiency;
+    double insurance_correlation;
+} CountSystemEfficiency;
+
+void eor_shoe_composition(int num_decks, double* composition);
+
+double eor_strategy_ev(Rules* rules, BasicStrategy* strategy, const double* composition);
+
+void eor_compute(Rules* rules, BasicStrategy* strategy, EorTable* table);
+
+void eor_evaluate_system(const EorTable* table, const CountSystem* system, CountSystemEfficiency* efficiency);
@@ -7,21 +7,54 @@
 #define SURRENDER_MULTIPLIER 0.5
 #define REGULAR_WIN_MULTIPLIER 1.0
 
+static void game_init_hands(GameState* game_state, Rules* rules, double initial_bet) {
+    game_state->player_hands = malloc(sizeof(Hand) * (rules->max_splits + 1));
+
+    for (int i = 0; i < rules->max_splits + 1; i++) {
+        hand_init(&game_state->player_hands[i]);
+    }
+
+    game_state->num_player_hands = 0;
+    hand_init(&game_state->dealer_hand);
+    dealer_table_init(&game_state->dealer_table, rules);
+
+    game_state->player_bets = malloc(sizeof(double) * (rules->max_splits + 1));
+    game_state->player_bets[0] = initial_bet;
+    game_state->insurance_bet = 0;
+    game_state->surrendered = false;
+    game_state->game_over = false;
+}
+
 void game_init(GameState* game_state, Rules* rules, double initial_bet) {
     game_state->rules = *rules;
     deck_init(&game_state->deck, rules->num_decks);
     deck_shuffle(&game_state->deck);
+    game_state->shoe = &game_state->deck;
 
-    game_state->player_hands = malloc(sizeof(Hand) * rules->max_splits + 1);
+    game_init_hands(game_state, rules, initial_bet);
+}
 
-    for (int i = 0; i < rules->max_splits + 1; i++) {
-        hand_init(&game_state->player_hands[i]);
+// A seat at a table: cards come from a shoe owned by the caller
+void game_init_shared(GameState* game_state, Rules* rules, double initial_bet, Deck* shoe) {
+    game_state->rules = *rules;
+    game_state->deck.cards = NULL;
+    game_state->deck.lazy_swaps = NULL;
+    game_state->deck.num_decks = 0;
+    game_state->deck.total_cards = 0;
+    game_state->deck.position = 0;
+    game_state->deck.mode = DECK_SHUFFLE_FULL;
+    game_state->shoe = shoe;
+
+    game_init_hands(game_state, rules, initial_bet);
+}
+
+void game_reset_round(GameState* game_state, double initial_bet) {
+    for (int i = 0; i < game_state->rules.max_splits + 1; i++) {
+        game_state->player_hands[i].num_cards = 0;
     }
 
     game_state->num_player_hands = 0;
-    hand_init(&game_state->dealer_hand);
-
-    game_state->player_bets = malloc(sizeof(double) * rules->max_splits + 1);
+    game_state->dealer_hand.num_cards = 0;
     game_state->player_bets[0] = initial_bet;
     game_state->insurance_bet = 0;
     game_state->surrendered = false;
@@ -30,19 +63,19 @@ void game_init(GameState* game_state, Rules* rules, double initial_bet) {
 
 void game_deal_initial(GameState* game_state) {
     for (int i = 0; i < DEFUALT_HAND_SIZE; i++) {
-        hand_add_card(&game_state->player_hands[game_state->num_player_hands], deck_deal(&game_state->deck));
+        hand_add_card(&game_state->player_hands[game_state->num_player_hands], deck_deal(game_state->shoe));
     }
     game_state->num_player_hands++;
 
     for (int i = 0; i < DEFUALT_HAND_SIZE; i++) {
-        hand_add_card(&game_state->dealer_hand, deck_deal(&game_state->deck));
+        hand_add_card(&game_state->dealer_hand, deck_deal(game_state->shoe));
     }
 }
 
 void game_play_action(GameState* game_state, PlayerAction player_action, int player_hand_index) {
     switch (player_action) {
         case HIT:
-            hand_add_card(&game_state->player_hands[player_hand_index], deck_deal(&game_state->deck));
+            hand_add_card(&game_state->player_hands[player_hand_index], deck_deal(game_state->shoe));
             break;
         case STAND:
             break;
@@ -50,13 +83,13 @@ void game_play_action(GameState* game_state, PlayerAction player_action, int pla
             int pop_card = hand_pop_card(&game_state->player_hands[player_hand_index]);
             hand_add_card(&game_state->player_hands[game_state->num_player_hands], pop_card);
             game_state->player_bets[game_state->num_player_hands] = game_state->player_bets[player_hand_index];
-            hand_add_card(&game_state->player_hands[player_hand_index], deck_deal(&game_state->deck));
-            hand_add_card(&game_state->player_hands[game_state->num_player_hands], deck_deal(&game_state->deck));
+            hand_add_card(&game_state->player_hands[player_hand_index], deck_deal(game_state->shoe));
+            hand_add_card(&game_state->player_hands[game_state->num_player_hands], deck_deal(game_state->shoe));
             game_state->num_player_hands++;
             break;
         case DOUBLE:
             game_state->player_bets[player_hand_index] *= 2;
-            hand_add_card(&game_state->player_hands[player_hand_index], deck_deal(&game_state->deck));
+            hand_add_card(&game_state->player_hands[player_hand_index], deck_deal(game_state->shoe));
             break;
         case SURRENDER:
             game_state->surrendered = true;
@@ -66,29 +99,58 @@ void game_play_action(GameState* game_state, PlayerAction player_action, int pla
     }
 }
 
+HandOutcome game_hand_outcome(GameState* game_state, int player_hand_index) {
+    Hand* player_hand = &game_state->player_hands[player_hand_index];
+    int player_hand_value = hand_get_value(player_hand);
+    int dealer_hand_value = hand_get_value(&game_state->dealer_hand);
+    bool player_natural = hand_is_blackjack(player_hand) && game_state->num_player_hands == 1;
+    bool dealer_natural = hand_is_blackjack(&game_state->dealer_hand);
+
+    if (game_state->surrendered) {
+        return HAND_SURRENDER;
+    } else if (player_hand_value > 21) {
+        return HAND_LOSE;
+    } else if (player_natural && !dealer_natural) {
+        return HAND_NATURAL;
+    } else if (dealer_hand_value > 21) {
+        return HAND_WIN;
+    } else if (dealer_natural && !player_natural) {
+        // Dealer blackjack beats any other 21
+        return HAND_LOSE;
+    } else if (player_hand_value < dealer_hand_value) {
+        return HAND_LOSE;
+    } else if (player_hand_value > dealer_hand_value) {
+        return HAND_WIN;
+    }
+    return HAND_PUSH;
+}
+
 double game_resolve(GameState* game_state) {
     double total_payout = 0;
 
     for (int i = 0; i < game_state->num_player_hands; i++) {
         double multiplier = DEFAULT_MULTIPLIER;
-        int player_hand_value = hand_get_value(&game_state->player_hands[i]);
-        int dealer_hand_value = hand_get_value(&game_state->dealer_hand);
         game_state->game_over = true;
 
-        
-        if (game_state->surrendered) {
-            multiplier = SURRENDER_MULTIPLIER;
-        } else if (dealer_hand_value > 21) {
-            multiplier += REGULAR_WIN_MULTIPLIER;
-        } else if (player_hand_value > 21 || player_hand_value < dealer_hand_value) {
-            multiplier = 0.0;
-        } else if (hand_is_blackjack(&game_state->player_hands[i]) && !hand_is_blackjack(&game_state->dealer_hand) && game_state->num_player_hands == 1) {
-            // Player has blackjack and dealer doesn't: 3:2 payout
-            multiplier += game_state->rules.blackjack_payout;
-        } else if (player_hand_value > dealer_hand_value) {
-            multiplier += REGULAR_WIN_MULTIPLIER;
+        switch (game_hand_outcome(game_state, i)) {
+            case HAND_LOSE:
+                multiplier = 0.0;
+                break;
+            case HAND_PUSH:
+            case HAND_NUM_OUTCOMES:     // Not an outcome; listed so -Wswitch flags new ones
+                // Push: multiplier stays at 1.0
+                break;
+            case HAND_WIN:
+                multiplier += REGULAR_WIN_MULTIPLIER;
+                break;
+            case HAND_NATURAL:
+                // Player has blackjack and dealer doesn't: 3:2 payout
+                multiplier += game_state->rules.blackjack_payout;
+                break;
+            case HAND_SURRENDER:
+                multiplier = SURRENDER_MULTIPLIER;
+                break;
         }
-        // Otherwise: push (player_hand_value == dealer_hand_value), multiplier stays at 1.0
 
         total_payout += game_state->player_bets[i] * multiplier;
     }
@@ -109,8 +171,71 @@ void game_take_insurance(GameState* game_state, double insurance_bet) {
 }
 
 void game_destroy(GameState* game_state) {
+    for (int i = 0; i < game_state->rules.max_splits + 1; i++) {
+        hand_destroy(&game_state->player_hands[i]);
+    }
     free(game_state->player_hands);
     free(game_state->player_bets);
     hand_destroy(&game_state->dealer_hand);
-    deck_destroy(&game_state->deck);
-}
\ No newline at end of file
+    if (game_state->shoe == &game_state->deck) {
+        deck_destroy(&game_state->deck);
+    }
+}
+
+static void copy_hand(Hand* to, const Hand* from) {
+    to->num_cards = 0;
+    for (int c = 0; c < from->num_cards; c++) {
+        hand_add_card(to, from->cards[c]);
+    }
+}
+
+void game_snapshot_init(GameSnapshot* snapshot, const Rules* rules) {
+    snapshot->max_hands = rules->max_splits + 1;
+    snapshot->player_hands = malloc(sizeof(Hand) * snapshot->max_hands);
+    snapshot->player_bets = malloc(sizeof(double) * snapshot->max_hands);
+    for (int i = 0; i < snapshot->max_hands; i++) {
+        hand_init(&snapshot->player_hands[i]);
+    }
+    snapshot->num_player_hands = 0;
+    hand_init(&snapshot->dealer_hand);
+}
+
+void game_snapshot_save(GameSnapshot* snapshot, const GameState* game_state) {
+    deck_mark(game_state->shoe, &snapshot->shoe);
+    snapshot->num_player_hands = game_state->num_player_hands;
+    for (int i = 0; i < game_state->num_player_hands; i++) {
+        copy_hand(&snapshot->player_hands[i], &game_state->player_hands[i]);
+        snapshot->player_bets[i] = game_state->player_bets[i];
+    }
+    copy_hand(&snapshot->dealer_hand, &game_state->dealer_hand);
+    snapshot->insurance_bet = game_state->insurance_bet;
+    snapshot->surrendered = game_state->surrendered;
+    snapshot->game_over = game_state->game_over;
+}
+
+void game_snapshot_restore(const GameSnapshot* snapshot, GameState* game_state) {
+    deck_rewind(game_state->shoe, &snapshot->shoe);
+    game_state->num_player_hands = snapshot->num_player_hands;
+    for (int i = 0; i < snapshot->max_hands; i++) {
+        if (i < snapshot->num_player_hands) {
+            copy_hand(&game_state->player_hands[i], &snapshot->player_hands[i]);
+            game_state->player_bets[i] = snapshot->player_bets[i];
+        } else {
+            // Splits since the save may have started this hand
+            game_state->player_hands[i].num_cards = 0;
+        }
+    }
+    copy_hand(&game_state->dealer_hand, &snapshot->dealer_hand);
+    game_state->insurance_bet = snapshot->insurance_bet;
+    game_state->surrendered = snapshot->surrendered;
+    game_state->game_over = snapshot->game_over;
+}
+
+void game_snapshot_destroy(GameSnapshot* snapshot) {
+    for (int i = 0; i < snapshot->max_hands; i++) {
+        hand_destroy(&snapshot->player_hands[i]);
+    }
+    free(snapshot->player_hands);
+    free(snapshot->player_bets);
+    hand_destroy(&snapshot->dealer_hand);
+}
@@ -2,6 +2,7 @@
 
 #include <stdbool.h>
 #include "deck.h"
+#include "dealer.h"
 #include "hand.h"
 #include "rules.h"
 
@@ -9,28 +10,72 @@ typedef enum {
     HIT, STAND, DOUBLE, SPLIT, SURRENDER
 } PlayerAction;
 
+// How a resolved hand paid, highest precedence first in game_hand_outcome()
+typedef enum {
+    HAND_LOSE,
+    HAND_PUSH,
+    HAND_WIN,
+    HAND_NATURAL,     // Blackjack against no dealer blackjack, paid blackjack_payout
+    HAND_SURRENDER,
+    HAND_NUM_OUTCOMES
+} HandOutcome;
+
 typedef struct {
     Deck deck;
+    Deck* shoe;  // Where cards are dealt from: &deck, or a shoe shared by every seat at a table
     Hand* player_hands;
     int num_player_hands;
     double* player_bets;
     double insurance_bet;
     Hand dealer_hand;
     Rules rules;
+    DealerTable dealer_table;  // Built from rules
     bool surrendered;
     bool game_over;
 } GameState;
 
+// A round as it stands: the hands, bets and flags copied into buffers of
+// their own, and a mark in the shoe rather than the shoe. Saving and restoring
+// cost the cards in the round plus, in lazy mode, the cards dealt in between.
+// Restoring deals the same cards again unless the shoe is branched.
+typedef struct {
+    DeckMark shoe;
+    Hand* player_hands;
+    double* player_bets;
+    int num_player_hands;
+    int max_hands;
+    double insurance_bet;
+    Hand dealer_hand;
+    bool surrendered;
+    bool game_over;
+} GameSnapshot;
+
 void game_init(GameState* game_state, Rules* rules, double initial_bet);
 
+void game_init_shared(GameState* game_state, Rules* rules, double initial_bet, Deck* shoe);
+
+void game_reset_round(GameState* game_state, double initial_bet);
+
 void game_deal_initial(GameState* game_state);
 
 void game_play_action(GameState* game_state, PlayerAction player_action, int player_hand_index);
 
+HandOutcome game_hand_outcome(GameState* game_state, int player_hand_index);
+
 double game_resolve(GameState* game_state);
 
 bool game_should_offer_insurance(GameState* game_state);
 
 void game_take_insurance(GameState* game_state, double insurance_bet);
 
-void game_destroy(GameState* game_state);
\ No newline at end of file
+void game_destroy(GameState* game_state);
+
+// Sized for games under rules; allocates once, so saves and restores don't
+void game_snapshot_init(GameSnapshot* snapshot, const Rules* rules);
+
+void game_snapshot_save(GameSnapshot* snapshot, const GameState* game_state);
+
+// Back to the saved round, on the same shoe it was saved from
+void game_snapshot_restore(const GameSnapshot* snapshot, GameState* game_state);
+
+void game_snapshot_destroy(GameSnapshot* snapshot);
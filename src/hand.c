@@ -31,23 +31,21 @@ int hand_pop_card(Hand* hand) {
 
 int hand_get_value(Hand* hand) {
     int sum = 0;
-    int ace_count = 0;
+    bool has_ace = false;
 
     for (int i = 0; i < hand->num_cards; i++) {
         int val = card_value(hand->cards[i]);
         if (val == ACE_MAX_VAL) {
-            ace_count++;
+            has_ace = true;
+            sum += ACE_MIN_VAL;
         } else {
-            sum += card_value(hand->cards[i]);
+            sum += val;
         }
     }
 
-    for (int i = 0; i < ace_count; i++) {
-        if (sum + ACE_MAX_VAL <= BLACKJACK_VAL) {
-            sum += ACE_MAX_VAL;
-        } else {
-            sum += 1;
-        }
+    // At most one ace can ever count as 11
+    if (has_ace && sum + ACE_MAX_VAL - ACE_MIN_VAL <= BLACKJACK_VAL) {
+        sum += ACE_MAX_VAL - ACE_MIN_VAL;
     }
 
     return sum;
@@ -59,18 +57,18 @@ bool hand_is_soft(Hand* hand) {
 
     for (int i = 0; i < hand->num_cards; i++) {
         int val = card_value(hand->cards[i]);
-        if (val != ACE_MAX_VAL) 
+        if (val == ACE_MAX_VAL) 
         {
-            sum += val;
+            has_ace = true;
+            sum += ACE_MIN_VAL;
         }
-
-        if (card_rank(hand->cards[i]) == 0) 
+        else
         {
-            has_ace = true;
+            sum += val;
         }
     }
 
-    if (has_ace && sum <= BLACKJACK_VAL - ACE_MAX_VAL) {
+    if (has_ace && sum + ACE_MAX_VAL - ACE_MIN_VAL <= BLACKJACK_VAL) {
         return true;
     }
 
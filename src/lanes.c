@@ -0,0 +1,366 @@
+#include "lanes.h"
+#include "card.h"
+#include <stdbool.h>
+
+#define LATER_STATES_PER_KIND 22     // Totals 0..21; busted hands never look anything up
+#define OPENING_CARDS 4              // Player, player, dealer upcard, dealer hole card
+
+typedef int16_t LaneVector __attribute__((vector_size(LANES_WIDTH * sizeof(int16_t))));
+
+// Rank index (A, 2, ..., 9, T) of every card a shoe can deal. Card-free shoes
+// deal rank indices directly, and those are the first ten entries.
+#define SUIT_RANKS 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 9, 9, 9
+static const int8_t card_rank_index[52] = { SUIT_RANKS, SUIT_RANKS, SUIT_RANKS, SUIT_RANKS };
+
+static const LaneVector lane_ids = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+_Static_assert(LANES_WIDTH <= SIMULATION_CONTEXT_GAMES, "every lane deals from its own game in the context");
+
+// One round per lane, struct-of-arrays. Masks are -1 in a lane where the
+// condition holds and 0 elsewhere, as vector compares produce them.
+typedef struct {
+    LaneVector player_hard;     // Aces count 1
+    LaneVector player_ace;      // Mask: the hand holds an ace
+    LaneVector player_drew;     // Mask: more than two cards, so not a natural
+    LaneVector dealer_state;    // DealerTable state
+    LaneVector dealer_natural;
+    LaneVector upcard;          // Rank index
+    LaneVector doubled;
+    LaneVector surrendered;
+    LaneVector split;           // Played out by the scalar engine instead
+    int cards[OPENING_CARDS][LANES_WIDTH];
+    double split_bets[LANES_WIDTH];
+    double split_payouts[LANES_WIDTH];
+} LaneRounds;
+
+static inline LaneVector broadcast(int value) {
+    return (LaneVector){0} + (int16_t)value;
+}
+
+static inline LaneVector select_lanes(LaneVector mask, LaneVector if_set, LaneVector otherwise) {
+    return (mask & if_set) | (~mask & otherwise);
+}
+
+static inline bool any_lane(LaneVector mask) {
+    int16_t any = 0;
+    for (int l = 0; l < LANES_WIDTH; l++) {
+        any |= mask[l];
+    }
+    return any != 0;
+}
+
+static inline int count_lanes(LaneVector mask) {
+    int count = 0;
+    for (int l = 0; l < LANES_WIDTH; l++) {
+        count -= mask[l];
+    }
+    return count;
+}
+
+// Best total: one ace counts 11 when that doesn't bust
+static inline LaneVector hand_total(LaneVector hard, LaneVector ace) {
+    return hard + (broadcast(10) & ace & (hard <= 11));
+}
+
+static inline LaneVector hand_soft(LaneVector hard, LaneVector ace) {
+    return ace & (hard <= 11);
+}
+
+// The only per-lane scalar work in the hot path: each lane has its own shoe
+static LaneVector draw_ranks(GameState* games, LaneVector mask, int* cards) {
+    LaneVector ranks = {0};
+    for (int l = 0; l < LANES_WIDTH; l++) {
+        if (mask[l]) {
+            int card = deck_deal(games[l].shoe);
+            ranks[l] = card_rank_index[card];
+            if (cards != NULL) {
+                cards[l] = card;
+            }
+        }
+    }
+    return ranks;
+}
+
+// Inactive lanes read entry 0 rather than branching
+static LaneVector gather(const int8_t* table, LaneVector index, LaneVector mask) {
+    index &= mask;
+    LaneVector values;
+    for (int l = 0; l < LANES_WIDTH; l++) {
+        values[l] = table[index[l]];
+    }
+    return values;
+}
+
+static PlayerAction query_strategy(Rules* rules, const BasicStrategy* strategy, const int* cards, int num_cards, int upcard,
+                                   bool can_split, bool can_double, bool can_surrender) {
+    Hand hand;
+    hand_init(&hand);
+    for (int i = 0; i < num_cards; i++) {
+        hand_add_card(&hand, cards[i]);
+    }
+
+    PlayerAction action = get_basic_strategy_action(&hand, upcard, rules, strategy, can_split, can_double, can_surrender);
+    hand_destroy(&hand);
+    return action;
+}
+
+// A hand that is hard `total`, for totals reachable after a hit
+static int hard_hand(int total, int* cards) {
+    if (total <= 11) {
+        cards[0] = 1;                       // A two...
+        cards[1] = total > 4 ? total - 3 : 1;  // ...and whatever makes the total, as a rank index
+        return 2;
+    }
+    if (total <= 20) {
+        cards[0] = 9;
+        cards[1] = total - 11;
+        return 2;
+    }
+    cards[0] = 9;
+    cards[1] = 8;
+    cards[2] = 1;
+    return 3;
+}
+
+// Card ints below 10 are rank indices A..T of the first suit, so the table
+// asks the same questions simulation_play_player_hands() would
+void lanes_compile_strategy(LaneStrategy* lane_strategy, Rules* rules, const BasicStrategy* strategy) {
+    bool splits_allowed = rules->max_splits > 0;
+
+    for (int up = 0; up < LANES_NUM_UPCARDS; up++) {
+        for (int first = 0; first < 10; first++) {
+            for (int second = 0; second < 10; second++) {
+                int cards[2] = { first, second };
+                lane_strategy->first[first * 10 + second][up] =
+                    (int8_t)query_strategy(rules, strategy, cards, 2, up, splits_allowed, true, true);
+            }
+        }
+
+        for (int total = 0; total < LATER_STATES_PER_KIND; total++) {
+            int cards[3];
+            int num_cards = hard_hand(total < 4 ? 4 : total, cards);
+            lane_strategy->later[total][up] =
+                (int8_t)query_strategy(rules, strategy, cards, num_cards, up, false, false, false);
+
+            int soft_cards[2] = { 0, total >= 12 ? total - 12 : 0 };  // Ace plus a rank index
+            lane_strategy->later[LATER_STATES_PER_KIND + total][up] =
+                (int8_t)query_strategy(rules, strategy, soft_cards, 2, up, false, false, false);
+        }
+    }
+}
+
+static void add_player_card(LaneRounds* rounds, LaneVector mask, LaneVector ranks) {
+    rounds->player_hard += (ranks + 1) & mask;
+    rounds->player_ace |= mask & (ranks == 0);
+    rounds->player_drew |= mask;
+}
+
+// A split goes to the scalar engine with the lane's shoe exactly where the
+// vector engine left it, so it plays out as simulation_run would play it.
+// Booking waits for the other lanes so rounds are recorded in order.
+static void play_split_lane(GameState* game, LaneRounds* rounds, int lane, SimulationConfig* simulation_config,
+                            SimulationResults* simulation_results) {
+    game_reset_round(game, simulation_config->bet_per_hand);
+    hand_add_card(&game->player_hands[0], rounds->cards[0][lane]);
+    hand_add_card(&game->player_hands[0], rounds->cards[1][lane]);
+    game->num_player_hands = 1;
+    hand_add_card(&game->dealer_hand, rounds->cards[2][lane]);
+    hand_add_card(&game->dealer_hand, rounds->cards[3][lane]);
+
+    simulation_play_player_hands(game, simulation_config, simulation_results);
+    if (!simulation_all_hands_busted(game)) {
+        simulation_play_dealer(game);
+    }
+    rounds->split_payouts[lane] = game_resolve(game);
+    rounds->split_bets[lane] = 0.0;
+    for (int h = 0; h < game->num_player_hands; h++) {
+        rounds->split_bets[lane] += game->player_bets[h];
+    }
+}
+
+// The rules that switch whole steps of a round on or off. Each kernel below
+// fixes them at compile time, so the compiler drops the steps a rule set never
+// takes; the rest of Rules is already folded into the strategy and dealer tables.
+typedef struct {
+    bool peeks;        // dealer_peeks_blackjack
+    bool splits;       // max_splits > 0
+    bool surrender;    // late_surrender_allowed
+} LaneRules;
+
+static inline __attribute__((always_inline)) void play_rounds(GameState* games, const LaneStrategy* lane_strategy,
+                                                              const DealerTable* dealer_table, int num_live, SimulationConfig* simulation_config,
+                                                              SimulationResults* simulation_results, const LaneRules lane_rules) {
+    Rules* rules = &simulation_config->rules;
+    LaneRounds rounds;
+    LaneVector live = lane_ids < broadcast(num_live);
+
+    // Deal in the scalar engine's order: two to the player, then the dealer
+    LaneVector first = draw_ranks(games, live, rounds.cards[0]);
+    LaneVector second = draw_ranks(games, live, rounds.cards[1]);
+    rounds.upcard = draw_ranks(games, live, rounds.cards[2]);
+    LaneVector hole = draw_ranks(games, live, rounds.cards[3]);
+
+    rounds.player_hard = first + second + 2;
+    rounds.player_ace = (first == 0) | (second == 0);
+    rounds.player_drew = broadcast(0);
+    rounds.dealer_state = gather(&dealer_table->next[0][0], rounds.upcard, live);
+    rounds.dealer_state = gather(&dealer_table->next[0][0], rounds.dealer_state * DEALER_NUM_RANKS + hole, live);
+    rounds.dealer_natural = live & (rounds.dealer_state == DEALER_STATE_SOFT + 21);
+    rounds.split = broadcast(0);
+    rounds.surrendered = broadcast(0);
+
+    LaneVector peeked = lane_rules.peeks ? rounds.dealer_natural : broadcast(0);
+    LaneVector acting = live & ~peeked;
+
+    // First decision, with every option on the table
+    LaneVector actions = gather(&lane_strategy->first[0][0], (first * 10 + second) * LANES_NUM_UPCARDS + rounds.upcard, acting);
+    rounds.doubled = acting & (actions == DOUBLE);
+    LaneVector hitting = acting & (actions == HIT);
+    if (lane_rules.surrender) {
+        rounds.surrendered = acting & (actions == SURRENDER);
+    }
+    if (lane_rules.splits) {
+        rounds.split = acting & (actions == SPLIT);
+        for (int l = 0; l < LANES_WIDTH; l++) {
+            if (rounds.split[l]) {
+                play_split_lane(&games[l], &rounds, l, simulation_config, simulation_results);
+            }
+        }
+    }
+
+    simulation_results->doubles_taken += count_lanes(rounds.doubled);
+    LaneVector drawing = rounds.doubled | hitting;
+    add_player_card(&rounds, drawing, draw_ranks(games, drawing, NULL));
+    acting = hitting & (hand_total(rounds.player_hard, rounds.player_ace) <= 21);
+
+    // Later decisions are hit or stand
+    while (any_lane(acting)) {
+        LaneVector soft = hand_soft(rounds.player_hard, rounds.player_ace);
+        LaneVector state = (soft & LATER_STATES_PER_KIND) + hand_total(rounds.player_hard, rounds.player_ace);
+        actions = gather(&lane_strategy->later[0][0], state * LANES_NUM_UPCARDS + rounds.upcard, acting);
+
+        hitting = acting & (actions == HIT);
+        add_player_card(&rounds, hitting, draw_ranks(games, hitting, NULL));
+        acting = hitting & (hand_total(rounds.player_hard, rounds.player_ace) <= 21);
+    }
+
+    LaneVector player_total = hand_total(rounds.player_hard, rounds.player_ace);
+    LaneVector dealer_playing = live & ~rounds.split & ~peeked & (player_total <= 21);
+    const int8_t* dealer_stands = (const int8_t*)dealer_table->stands;
+    for (;;) {
+        LaneVector hit = dealer_playing & (gather(dealer_stands, rounds.dealer_state, dealer_playing) == 0);
+        if (!any_lane(hit)) {
+            break;
+        }
+
+        LaneVector ranks = draw_ranks(games, hit, NULL);
+        LaneVector next = gather(&dealer_table->next[0][0], rounds.dealer_state * DEALER_NUM_RANKS + ranks, hit);
+        rounds.dealer_state = select_lanes(hit, next, rounds.dealer_state);
+    }
+
+    // Same precedence as game_resolve(), highest last
+    LaneVector dealer_total = gather(dealer_table->total, rounds.dealer_state, live);
+    LaneVector natural = ~rounds.player_drew & (player_total == 21);
+    LaneVector outcome = select_lanes(player_total > dealer_total, broadcast(HAND_WIN),
+                                      select_lanes(player_total < dealer_total, broadcast(HAND_LOSE), broadcast(HAND_PUSH)));
+    outcome = select_lanes(rounds.dealer_natural & ~natural, broadcast(HAND_LOSE), outcome);
+    outcome = select_lanes(dealer_total > 21, broadcast(HAND_WIN), outcome);
+    outcome = select_lanes(natural & ~rounds.dealer_natural, broadcast(HAND_NATURAL), outcome);
+    outcome = select_lanes(player_total > 21, broadcast(HAND_LOSE), outcome);
+    if (lane_rules.surrender) {
+        outcome = select_lanes(rounds.surrendered, broadcast(HAND_SURRENDER), outcome);
+    }
+
+    const double multipliers[HAND_NUM_OUTCOMES] = { 0.0, 1.0, 2.0, 1.0 + rules->blackjack_payout, 0.5 };
+    double initial_bet = simulation_config->bet_per_hand;
+    for (int l = 0; l < num_live; l++) {
+        if (lane_rules.splits && rounds.split[l]) {
+            simulation_record_payout(simulation_results, rounds.split_bets[l], rounds.split_payouts[l], initial_bet, NULL, 0);
+            simulation_record_outcomes(simulation_results, &games[l], initial_bet, rounds.split_bets[l], rounds.split_payouts[l]);
+        } else {
+            double bet = rounds.doubled[l] ? initial_bet * 2 : initial_bet;
+            simulation_record_payout(simulation_results, bet, bet * multipliers[outcome[l]], initial_bet, NULL, 0);
+            payout_table_record_hand(&simulation_results->payouts, outcome[l], rounds.doubled[l] != 0, false);
+            payout_table_record_round(&simulation_results->payouts, bet * (multipliers[outcome[l]] - 1.0) / initial_bet,
+                                      outcome[l] == HAND_NATURAL, rounds.upcard[l] == 0, rounds.dealer_natural[l] != 0);
+        }
+    }
+}
+
+typedef void (*LaneKernel)(GameState* games, const LaneStrategy* lane_strategy,
+                           const DealerTable* dealer_table, int num_live, SimulationConfig* simulation_config,
+                           SimulationResults* simulation_results);
+
+#define LANE_KERNEL(name, peeks, splits, surrender)                                                                      \
+    static void name(GameState* games, const LaneStrategy* lane_strategy,                            \
+                     const DealerTable* dealer_table, int num_live, SimulationConfig* simulation_config,                \
+                     SimulationResults* simulation_results) {                                                            \
+        play_rounds(games, lane_strategy, dealer_table, num_live, simulation_config, simulation_results,  \
+                    (LaneRules){ peeks, splits, surrender });                                                            \
+    }
+
+LANE_KERNEL(play_rounds_peek_surrender, true, true, true)     // rules_init(): US shoe game
+LANE_KERNEL(play_rounds_peek, true, true, false)              // US without surrender
+LANE_KERNEL(play_rounds_no_peek, false, true, false)          // European no-hole-card style
+
+// Anything else reads the rules at run time
+static void play_rounds_generic(GameState* games, const LaneStrategy* lane_strategy,
+                                const DealerTable* dealer_table, int num_live, SimulationConfig* simulation_config,
+                                SimulationResults* simulation_results) {
+    Rules* rules = &simulation_config->rules;
+    LaneRules lane_rules = { rules->dealer_peeks_blackjack, rules->max_splits > 0, rules->late_surrender_allowed };
+    play_rounds(games, lane_strategy, dealer_table, num_live, simulation_config, simulation_results, lane_rules);
+}
+
+static LaneKernel lane_kernel(Rules* rules) {
+    if (rules->max_splits > 0) {
+        if (rules->dealer_peeks_blackjack) {
+            return rules->late_surrender_allowed ? play_rounds_peek_surrender : play_rounds_peek;
+        }
+        if (!rules->late_surrender_allowed) {
+            return play_rounds_no_peek;
+        }
+    }
+    return play_rounds_generic;
+}
+
+// Runs the same rounds as simulation_run, LANES_WIDTH at a time. Only the
+// fresh-shoe-per-round case vectorizes: a counted shoe is one long dependent
+// sequence, so counting and wonging runs go to simulation_run.
+void lanes_run(SimulationConfig* simulation_config, SimulationResults* simulation_results) {
+    SimulationContext context;
+    simulation_context_init(&context);
+    lanes_run_in(&context, simulation_config, simulation_results);
+    simulation_context_destroy(&context);
+}
+
+// Lane l deals from the context's game l, which also plays the lane's splits
+void lanes_run_in(SimulationContext* context, SimulationConfig* simulation_config, SimulationResults* simulation_results) {
+    if (simulation_config->count_systems != NULL && simulation_config->num_count_systems > 0) {
+        simulation_run_in(context, simulation_config, simulation_results);
+        return;
+    }
+
+    LaneStrategy lane_strategy;
+    lanes_compile_strategy(&lane_strategy, &simulation_config->rules, &simulation_config->strategy);
+    DealerTable dealer_table;
+    dealer_table_init(&dealer_table, &simulation_config->rules);
+    LaneKernel kernel = lane_kernel(&simulation_config->rules);
+    simulation_context_prepare(context, simulation_config, LANES_WIDTH);
+    GameState* games = context->games;
+
+    // With a seed, round k is shoe first_shoe + k whichever lane deals it
+    for (int first_round = 0; first_round < simulation_config->num_hands; first_round += LANES_WIDTH) {
+        int num_live = simulation_config->num_hands - first_round;
+        num_live = num_live < LANES_WIDTH ? num_live : LANES_WIDTH;
+
+        for (int l = 0; l < num_live; l++) {
+            if (simulation_config->seed != 0) {
+                deck_seed(games[l].shoe, simulation_config->seed, simulation_config->first_shoe + first_round + l);
+            }
+            deck_shuffle(games[l].shoe);
+        }
+
+        kernel(games, &lane_strategy, &dealer_table, num_live, simulation_config, simulation_results);
+    }
+}
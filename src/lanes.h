@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+#include "simulation.h"
+
+#define LANES_WIDTH 8                 // Rounds in flight, one per 16-bit lane of a baseline 128-bit vector
+#define LANES_FIRST_STATES 100        // Two-card hands: first rank x second rank
+#define LANES_LATER_STATES (2 * 22)   // Hands of three or more cards: hard/soft x total
+#define LANES_NUM_UPCARDS 10
+
+// Basic strategy flattened into action tables so each lane's decision is one
+// indexed load. Built by asking get_basic_strategy_action() about every state,
+// so both engines make the same decision in every state.
+typedef struct {
+    int8_t first[LANES_FIRST_STATES][LANES_NUM_UPCARDS];  // Unsplit two-card hands: split, double and surrender offered
+    int8_t later[LANES_LATER_STATES][LANES_NUM_UPCARDS];  // Everything after the first card drawn
+} LaneStrategy;
+
+void lanes_compile_strategy(LaneStrategy* lane_strategy, Rules* rules, const BasicStrategy* strategy);
+
+void lanes_run(SimulationConfig* simulation_config, SimulationResults* simulation_results);
+
+void lanes_run_in(SimulationContext* context, SimulationConfig* simulation_config, SimulationResults* simulation_results);
@@ -0,0 +1,381 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simulation.h"
+#include "lanes.h"
+#include "benchmark.h"
+#include "cpu.h"
+#include "chart.h"
+#include "strategy_file.h"
+#include "sweep.h"
+#include "paired.h"
+
+#define DEFAULT_NUM_HANDS 1000000
+#define COMPARE_DEFAULT_ROUNDS 1000000
+#define COMPARE_DEFAULT_SEED 20240601
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "Usage: %s [hands]                     Basic strategy simulation\n", program);
+    fprintf(stderr, "       %s bench [options]             Count system SCORE benchmark\n", program);
+    fprintf(stderr, "       %s scaling [options]           Throughput at 1, 2, 4, ... threads\n", program);
+    fprintf(stderr, "       %s sweep [options] [RULE=V,...]  House edge for every combination of rule values\n", program);
+    fprintf(stderr, "       %s compare [options] RULE=V... vs RULE=V...  Paired difference between two rule sets\n", program);
+    fprintf(stderr, "       %s strategies pack OUT CHART...  Pack text charts into a binary strategy file\n", program);
+    fprintf(stderr, "       %s strategies list FILE          Name every strategy in a binary file\n", program);
+    fprintf(stderr, "       %s strategies export FILE [NAME] Print strategies from a binary file as charts\n", program);
+    fprintf(stderr, "\nBenchmark options:\n");
+    fprintf(stderr, "  --rounds N    Rounds per penetration (default 4000000)\n");
+    fprintf(stderr, "  --batches N   Independent batches per penetration (default 64, max %d)\n", BENCHMARK_MAX_BATCHES);
+    fprintf(stderr, "  --threads N   Worker threads (default: online CPUs)\n");
+    fprintf(stderr, "  --seed N      Nonzero shoe seed (default 20240601)\n");
+    fprintf(stderr, "\nScaling options:\n");
+    fprintf(stderr, "  --threads N   Largest thread count (default: online CPUs)\n");
+    fprintf(stderr, "  --rounds N    Rounds per step, or per thread with --weak (default 8000000)\n");
+    fprintf(stderr, "  --weak        Weak scaling: the job grows with the thread count\n");
+    fprintf(stderr, "  --counting    Counted shoes with every built-in system instead of fresh shoes\n");
+    fprintf(stderr, "  --pin MODE    none, cores (one CPU per thread) or nodes (threads spread over NUMA nodes)\n");
+    fprintf(stderr, "  --seed N      Nonzero shoe seed (default 20240601)\n");
+    fprintf(stderr, "\nCompare options:\n");
+    fprintf(stderr, "  --rounds N    Rounds, each on a fresh shoe (default %d)\n", COMPARE_DEFAULT_ROUNDS);
+    fprintf(stderr, "  --seed N      Nonzero shoe seed (default %d)\n", COMPARE_DEFAULT_SEED);
+    fprintf(stderr, "\nSweep options:\n");
+    fprintf(stderr, "  --rounds N    Rounds per configuration (default %d)\n", SWEEP_DEFAULT_ROUNDS);
+    fprintf(stderr, "  --threads N   Worker threads (default: online CPUs)\n");
+    fprintf(stderr, "  --seed N      Nonzero shoe seed (default 20240601)\n");
+    fprintf(stderr, "  --shoe        Deal each shoe down to its penetration instead of a fresh shoe per round\n");
+    fprintf(stderr, "  --list FILE   Add one grid per line of FILE\n");
+    fprintf(stderr, "  Rules: decks, h17, das, surrender, peek, splits, rsa, payout (1.5 or 3:2), penetration\n");
+    fprintf(stderr, "\nSet BLACKJACK_CPU=scalar|avx2|avx512 to cap the kernels picked at startup (%s here).\n",
+            cpu_level_name(cpu_detect()));
+}
+
+static int run_simulation(int num_hands) {
+    SimulationConfig config = {0};
+    rules_init(&config.rules);
+    basic_strategy_init(&config.strategy);
+    config.num_hands = num_hands;
+    config.bet_per_hand = 1.0;
+
+    SimulationResults results = {0};
+    lanes_run(&config, &results);
+
+    printf("Hands played: %d\n", results.hands_played);
+    printf("Won / lost / pushed: %d / %d / %d\n", results.hands_won, results.hands_lost, results.hands_pushed);
+    printf("Doubles: %d, splits: %d\n", results.doubles_taken, results.splits_taken);
+    printf("EV: %+.3f%%\n", 100.0 * simulation_get_ev(&results));
+    return 0;
+}
+
+static int run_benchmark(int argc, char** argv) {
+    BenchmarkConfig config;
+    benchmark_config_standard(&config);
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        int value = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--rounds") == 0) {
+            config.rounds_per_penetration = value;
+        } else if (strcmp(argv[i], "--batches") == 0) {
+            config.num_batches = value;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            config.num_threads = value;
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            config.seed = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    // One batch would leave no spread to take an interval from
+    if (config.num_batches < 2 || !benchmark_config_valid(&config)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    static BenchmarkResults results;
+    if (!benchmark_run(&config, &results)) {
+        fprintf(stderr, "bench: could not start the simulation threads\n");
+        return 1;
+    }
+    benchmark_print(stdout, &config, &results);
+    return 0;
+}
+
+static int run_scaling(int argc, char** argv) {
+    BenchmarkScalingConfig config;
+    benchmark_scaling_config_standard(&config);
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--weak") == 0) {
+            config.weak = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--counting") == 0) {
+            config.num_systems = count_system_num_builtin();
+            for (int s = 0; s < config.num_systems; s++) {
+                count_system_builtin(s, &config.systems[s]);
+            }
+            continue;
+        }
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        const char* value = argv[i + 1];
+        if (strcmp(argv[i], "--threads") == 0) {
+            config.max_threads = atoi(value);
+        } else if (strcmp(argv[i], "--rounds") == 0) {
+            config.rounds = atoi(value);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            config.seed = atoi(value);
+        } else if (strcmp(argv[i], "--pin") == 0 && strcmp(value, "none") == 0) {
+            config.pinning = POOL_PIN_NONE;
+        } else if (strcmp(argv[i], "--pin") == 0 && strcmp(value, "cores") == 0) {
+            config.pinning = POOL_PIN_CORES;
+        } else if (strcmp(argv[i], "--pin") == 0 && strcmp(value, "nodes") == 0) {
+            config.pinning = POOL_PIN_NODES;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (config.max_threads < 1 || config.rounds < 1 || config.seed == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    BenchmarkScalingResults results;
+    if (!benchmark_scaling_run(&config, &results)) {
+        fprintf(stderr, "scaling: could not start the simulation threads\n");
+        return 1;
+    }
+    benchmark_scaling_print(stdout, &config, &results);
+    return 0;
+}
+
+static int run_sweep(int argc, char** argv) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    char axes[1024] = "";  // The command line's RULE=V,... arguments, one grid together
+    bool ok = true;
+
+    for (int i = 2; ok && i < argc; i++) {
+        if (strcmp(argv[i], "--shoe") == 0) {
+            sweep.through_shoe = true;
+            continue;
+        }
+        if (strncmp(argv[i], "--", 2) != 0) {
+            size_t length = strlen(axes);
+            snprintf(axes + length, sizeof(axes) - length, "%s ", argv[i]);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            ok = false;
+            break;
+        }
+
+        const char* value = argv[++i];
+        if (strcmp(argv[i - 1], "--rounds") == 0) {
+            sweep.rounds = atoi(value);
+        } else if (strcmp(argv[i - 1], "--threads") == 0) {
+            sweep.num_threads = atoi(value);
+        } else if (strcmp(argv[i - 1], "--seed") == 0) {
+            sweep.seed = atoi(value);
+        } else if (strcmp(argv[i - 1], "--list") == 0) {
+            ok = sweep_add_list(&sweep, value);
+        } else {
+            ok = false;
+        }
+    }
+
+    // Without any grid, the default rules alone
+    SweepGrid grid;
+    if (ok && (axes[0] != '\0' || sweep.num_entries == 0)) {
+        ok = sweep_parse_grid(axes, "command line", &grid);
+        if (ok && !sweep_add_grid(&sweep, &grid)) {
+            fprintf(stderr, "command line: out of memory\n");
+            ok = false;
+        }
+    }
+
+    if (!ok || sweep.rounds < 1 || sweep.seed == 0) {
+        print_usage(argv[0]);
+        sweep_destroy(&sweep);
+        return 1;
+    }
+
+    sweep_print_header(stdout);
+    bool ran = sweep_run(&sweep, stdout);
+    sweep_destroy(&sweep);
+    if (!ran) {
+        fprintf(stderr, "sweep: could not queue or run the simulations\n");
+        return 1;
+    }
+    return 0;
+}
+
+// One rule set from sweep rule values, each naming a single value
+static bool parse_rules(const char* text, Rules* rules) {
+    SweepGrid grid;
+    if (!sweep_parse_grid(text, "command line", &grid)) {
+        return false;
+    }
+
+    Sweep sweep;
+    sweep_init(&sweep);
+    bool ok = sweep_add_grid(&sweep, &grid) && sweep.num_entries == 1;
+    if (ok) {
+        *rules = sweep.entries[0].rules;
+    } else if (sweep.num_entries <= 1) {
+        fprintf(stderr, "command line: out of memory\n");
+    } else {
+        fprintf(stderr, "command line: a compared rule set takes one value per rule\n");
+    }
+    sweep_destroy(&sweep);
+    return ok;
+}
+
+static int run_compare(int argc, char** argv) {
+    char sides[2][1024] = { "", "" };
+    int side = 0;
+    int rounds = COMPARE_DEFAULT_ROUNDS;
+    int seed = COMPARE_DEFAULT_SEED;
+    bool ok = true;
+
+    for (int i = 2; ok && i < argc; i++) {
+        if (strcmp(argv[i], "vs") == 0) {
+            ok = side == 0;
+            side = 1;
+        } else if (strncmp(argv[i], "--", 2) != 0) {
+            size_t length = strlen(sides[side]);
+            snprintf(sides[side] + length, sizeof(sides[side]) - length, "%s ", argv[i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--rounds") == 0) {
+            rounds = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0) {
+            seed = atoi(argv[++i]);
+        } else {
+            ok = false;
+        }
+    }
+
+    Rules rules_a, rules_b;
+    ok = ok && side == 1 && rounds > 0 && seed != 0;
+    ok = ok && parse_rules(sides[0], &rules_a) && parse_rules(sides[1], &rules_b);
+    if (!ok) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (!paired_rules_supported(&rules_a, &rules_b)) {
+        fprintf(stderr, "command line: the two rule sets must share decks, splits, peek and hole card\n");
+        return 1;
+    }
+
+    PairedConfig paired;
+    paired_config_init(&paired, &rules_a, &rules_b, rounds, seed);
+    PairedResults results = {0};
+    paired_run(&paired, &results);
+
+    printf("Rounds:          %ld (%.2f%% played differently)\n", results.rounds,
+           100.0 * results.diverged / results.rounds);
+    printf("EV A:            %+.4f%%\n", 100.0 * paired_get_ev_a(&results));
+    printf("EV B:            %+.4f%%\n", 100.0 * paired_get_ev_b(&results));
+    printf("B - A:           %+.4f%% +/- %.4f%% (paired SE)\n", 100.0 * paired_get_difference(&results),
+           100.0 * paired_get_difference_standard_error(&results));
+    printf("Independent SE:  %.4f%%\n", 100.0 * paired_get_independent_standard_error(&results));
+    return 0;
+}
+
+static int pack_strategies(const char* output, int num_charts, char** chart_paths) {
+    StrategyRecord* records = calloc(num_charts, sizeof(StrategyRecord));
+    bool ok = records != NULL;
+    for (int c = 0; ok && c < num_charts; c++) {
+        ok = chart_load(chart_paths[c], records[c].name, &records[c].strategy);
+    }
+
+    ok = ok && strategy_file_save(output, records, num_charts);
+    free(records);
+    return ok ? 0 : 1;
+}
+
+static int run_strategies(int argc, char** argv) {
+    if (argc >= 5 && strcmp(argv[2], "pack") == 0) {
+        return pack_strategies(argv[3], argc - 4, &argv[4]);
+    }
+
+    bool list = argc == 4 && strcmp(argv[2], "list") == 0;
+    bool export = (argc == 4 || argc == 5) && strcmp(argv[2], "export") == 0;
+    if (!list && !export) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    StrategyFile file;
+    if (!strategy_file_open(&file, argv[3])) {
+        return 1;
+    }
+
+    int found = 0;
+    for (int r = 0; r < file.num_strategies; r++) {
+        const StrategyRecord* record = &file.records[r];
+        if (list) {
+            printf("%s\n", record->name);
+        } else if (argc == 4 || strcmp(record->name, argv[4]) == 0) {
+            if (found > 0) {
+                printf("\n");
+            }
+            chart_write(stdout, record->name, &record->strategy);
+            found++;
+        }
+    }
+    strategy_file_close(&file);
+
+    if (export && found == 0) {
+        fprintf(stderr, "%s: no strategy named %s\n", argv[3], argc == 5 ? argv[4] : "");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark(argc, argv);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "scaling") == 0) {
+        return run_scaling(argc, argv);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "sweep") == 0) {
+        return run_sweep(argc, argv);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "compare") == 0) {
+        return run_compare(argc, argv);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "strategies") == 0) {
+        return run_strategies(argc, argv);
+    }
+
+    if (argc >= 2 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    int num_hands = argc >= 2 ? atoi(argv[1]) : DEFAULT_NUM_HANDS;
+    if (num_hands <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    return run_simulation(num_hands);
+}
@@ -0,0 +1,193 @@
+#include <math.h>
+#include "paired.h"
+
+// One rule set's view of the shared game
+typedef struct {
+    SimulationConfig config;
+    DealerTable dealer_table;
+} PairedSide;
+
+// Paid by side's rules, per initial bet
+static double resolve(GameState* game, PairedSide* side, double initial_bet) {
+    game->rules = side->config.rules;
+    double round_payout = game_resolve(game);
+    double round_bets = 0.0;
+    for (int h = 0; h < game->num_player_hands; h++) {
+        round_bets += game->player_bets[h];
+    }
+    return (round_payout - round_bets) / initial_bet;
+}
+
+// From an open hand (or, with hand_index -1, the dealer's next card) to the
+// end of the round, as side alone would play it
+static double finish_round(GameState* game, PairedSide* side, int hand_index, double initial_bet) {
+    if (hand_index >= 0) {
+        simulation_play_player_hands_from(game, &side->config, NULL, hand_index);
+    }
+    if (!simulation_all_hands_busted(game)) {
+        dealer_play(&side->dealer_table, &game->dealer_hand, game->shoe);
+    }
+    return resolve(game, side, initial_bet);
+}
+
+static void fork_round(GameState* game, PairedSide* sides, GameSnapshot* fork, int hand_index, double initial_bet,
+                       double* results) {
+    game_snapshot_save(fork, game);
+    results[0] = finish_round(game, &sides[0], hand_index, initial_bet);
+    game_snapshot_restore(fork, game);
+    results[1] = finish_round(game, &sides[1], hand_index, initial_bet);
+}
+
+// Plays one round for both sides; returns true if it had to fork
+static bool play_round(GameState* game, PairedSide* sides, GameSnapshot* fork, double initial_bet, double* results) {
+    game_reset_round(game, initial_bet);
+    game_deal_initial(game);
+
+    bool dealer_has_blackjack = sides[0].config.rules.dealer_peeks_blackjack && hand_is_blackjack(&game->dealer_hand);
+    if (!dealer_has_blackjack) {
+        for (int h = 0; h < game->num_player_hands; h++) {
+            PlayerAction action;
+            do {
+                action = simulation_choose_action(game, &sides[0].config, h);
+                if (action != simulation_choose_action(game, &sides[1].config, h)) {
+                    fork_round(game, sides, fork, h, initial_bet, results);
+                    return true;
+                }
+                game_play_action(game, action, h);
+            } while ((action == HIT || action == SPLIT) && hand_get_value(&game->player_hands[h]) <= 21);
+        }
+    }
+
+    // The dealer draws for both until one table stands where the other hits
+    if (!dealer_has_blackjack && !simulation_all_hands_busted(game)) {
+        const DealerTable* table_a = &sides[0].dealer_table;
+        const DealerTable* table_b = &sides[1].dealer_table;
+        int state_a = dealer_hand_state(table_a, &game->dealer_hand);
+        int state_b = dealer_hand_state(table_b, &game->dealer_hand);
+        while (!table_a->stands[state_a] || !table_b->stands[state_b]) {
+            if (table_a->stands[state_a] != table_b->stands[state_b]) {
+                fork_round(game, sides, fork, -1, initial_bet, results);
+                return true;
+            }
+            int card = deck_deal(game->shoe);
+            hand_add_card(&game->dealer_hand, card);
+            state_a = table_a->next[state_a][dealer_rank_index(card)];
+            state_b = table_b->next[state_b][dealer_rank_index(card)];
+        }
+    }
+
+    results[0] = resolve(game, &sides[0], initial_bet);
+    results[1] = resolve(game, &sides[1], initial_bet);
+    return false;
+}
+
+void paired_config_init(PairedConfig* paired_config, const Rules* rules_a, const Rules* rules_b, int num_hands, uint64_t seed) {
+    SimulationConfig blank = {0};
+    paired_config->config = blank;
+    paired_config->config.rules = *rules_a;
+    basic_strategy_for_rules(&paired_config->config.strategy, rules_a, NULL);
+    paired_config->config.num_hands = num_hands;
+    paired_config->config.bet_per_hand = 1.0;
+    paired_config->config.seed = seed;
+    paired_config->rules_b = *rules_b;
+    basic_strategy_for_rules(&paired_config->strategy_b, rules_b, NULL);
+}
+
+// The two sides share one game, so they must deal it and size it alike
+bool paired_rules_supported(const Rules* a, const Rules* b) {
+    return a->num_decks == b->num_decks && a->max_splits == b->max_splits &&
+           a->dealer_peeks_blackjack == b->dealer_peeks_blackjack && a->european_no_hole_card == b->european_no_hole_card;
+}
+
+bool paired_run_in(SimulationContext* context, PairedConfig* paired_config, PairedResults* results) {
+    SimulationConfig* config = &paired_config->config;
+    if (!paired_rules_supported(&config->rules, &paired_config->rules_b) || config->count_systems != NULL) {
+        return false;
+    }
+
+    simulation_context_prepare(context, config, 1);
+    GameState* game = &context->games[0];
+    if (config->seed != 0) {
+        deck_seed(&game->deck, config->seed, config->first_shoe);
+    }
+
+    PairedSide sides[2];
+    sides[0].config = *config;
+    sides[1].config = *config;
+    sides[1].config.rules = paired_config->rules_b;
+    sides[1].config.strategy = paired_config->strategy_b;
+    for (int s = 0; s < 2; s++) {
+        dealer_table_init(&sides[s].dealer_table, &sides[s].config.rules);
+    }
+
+    GameSnapshot fork;
+    game_snapshot_init(&fork, &config->rules);
+
+    for (int i = 0; i < config->num_hands; i++) {
+        // A fresh shoe every round, round k being shoe first_shoe + k as in simulation_run
+        deck_shuffle(&game->deck);
+
+        double round_results[2];
+        results->diverged += play_round(game, sides, &fork, config->bet_per_hand, round_results);
+        double difference = round_results[1] - round_results[0];
+        results->rounds++;
+        results->total_a += round_results[0];
+        results->total_b += round_results[1];
+        results->total_a_squared += round_results[0] * round_results[0];
+        results->total_b_squared += round_results[1] * round_results[1];
+        results->difference_squared += difference * difference;
+    }
+
+    game->rules = config->rules;
+    game_snapshot_destroy(&fork);
+    return true;
+}
+
+bool paired_run(PairedConfig* paired_config, PairedResults* results) {
+    SimulationContext context;
+    simulation_context_init(&context);
+    bool ok = paired_run_in(&context, paired_config, results);
+    simulation_context_destroy(&context);
+    return ok;
+}
+
+void paired_results_add(PairedResults* total, const PairedResults* results) {
+    total->rounds += results->rounds;
+    total->diverged += results->diverged;
+    total->total_a += results->total_a;
+    total->total_b += results->total_b;
+    total->total_a_squared += results->total_a_squared;
+    total->total_b_squared += results->total_b_squared;
+    total->difference_squared += results->difference_squared;
+}
+
+double paired_get_ev_a(const PairedResults* results) {
+    return results->rounds > 0 ? results->total_a / results->rounds : 0.0;
+}
+
+double paired_get_ev_b(const PairedResults* results) {
+    return results->rounds > 0 ? results->total_b / results->rounds : 0.0;
+}
+
+double paired_get_difference(const PairedResults* results) {
+    return results->rounds > 0 ? (results->total_b - results->total_a) / results->rounds : 0.0;
+}
+
+static double standard_error(double sum, double sum_squared, long n) {
+    if (n < 2) {
+        return 0.0;
+    }
+    double mean = sum / n;
+    double variance = (sum_squared / n - mean * mean) * n / (n - 1);
+    return sqrt(variance > 0 ? variance / n : 0.0);
+}
+
+double paired_get_difference_standard_error(const PairedResults* results) {
+    return standard_error(results->total_b - results->total_a, results->difference_squared, results->rounds);
+}
+
+double paired_get_independent_standard_error(const PairedResults* results) {
+    double a = standard_error(results->total_a, results->total_a_squared, results->rounds);
+    double b = standard_error(results->total_b, results->total_b_squared, results->rounds);
+    return sqrt(a * a + b * b);
+}
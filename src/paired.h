@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include "simulation.h"
+
+// Two rule sets played on the same rounds. Each round is dealt once and both
+// rule sets play it together until the first decision they make differently
+// (a player action or the dealer hitting or standing); only then is the round
+// forked and finished once under each. Most rules, like H17, DAS or late
+// surrender, change a few rounds in a hundred, so the difference between the
+// two is measured on the rounds where it happens and nowhere else.
+typedef struct {
+    SimulationConfig config;     // Rules and strategy A, rounds, bet, seed; fresh shoes, no counting
+    Rules rules_b;               // Must match A on decks, splits, peeking and hole card
+    BasicStrategy strategy_b;
+} PairedConfig;
+
+typedef struct {
+    long rounds;
+    long diverged;               // Rounds the two rule sets played differently
+    double total_a;              // Sums of round results, in units of the initial bet
+    double total_b;
+    double total_a_squared;
+    double total_b_squared;
+    double difference_squared;   // Sum of (b - a)^2 over rounds
+} PairedResults;
+
+// Each side gets the chart basic_strategy_for_rules picks for it; flat bets of 1
+void paired_config_init(PairedConfig* paired_config, const Rules* rules_a, const Rules* rules_b, int num_hands, uint64_t seed);
+
+bool paired_rules_supported(const Rules* a, const Rules* b);
+
+// false (and nothing run) when the rules can't be paired or the config counts
+bool paired_run_in(SimulationContext* context, PairedConfig* paired_config, PairedResults* results);
+
+bool paired_run(PairedConfig* paired_config, PairedResults* results);
+
+void paired_results_add(PairedResults* total, const PairedResults* results);
+
+double paired_get_ev_a(const PairedResults* results);
+
+double paired_get_ev_b(const PairedResults* results);
+
+// b - a per round, and its standard error from the paired rounds
+double paired_get_difference(const PairedResults* results);
+
+double paired_get_difference_standard_error(const PairedResults* results);
+
+// What the standard error would be had a and b been run on separate shoes
+double paired_get_independent_standard_error(const PairedResults* results);
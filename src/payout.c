@@ -0,0 +1,123 @@
+#include <math.h>
+#include "payout.h"
+
+#define INSURANCE_FRACTION 0.5   // Insurance is half the initial bet
+
+static const char* category_names[PAYOUT_NUM_CATEGORIES] = {
+    "natural", "win", "push", "lose",
+    "doubled win", "doubled push", "doubled lose",
+    "split win", "split push", "split lose",
+    "split doubled win", "split doubled push", "split doubled lose",
+    "surrender"
+};
+
+// Net result per initial bet; naturals are paid by the variant instead
+static const double category_results[PAYOUT_NUM_CATEGORIES] = {
+    0.0, 1.0, 0.0, -1.0,
+    2.0, 0.0, -2.0,
+    1.0, 0.0, -1.0,
+    2.0, 0.0, -2.0,
+    -0.5
+};
+
+const char* payout_category_name(PayoutCategory category) {
+    return category_names[category];
+}
+
+PayoutCategory payout_category(HandOutcome outcome, bool doubled, bool split) {
+    switch (outcome) {
+        case HAND_NATURAL:
+            return PAYOUT_NATURAL;
+        case HAND_SURRENDER:
+            return PAYOUT_SURRENDER;
+        default:
+            break;
+    }
+
+    // WIN, PUSH, LOSE in that order within each group
+    int base = outcome == HAND_WIN ? 0 : outcome == HAND_PUSH ? 1 : 2;
+    if (split) {
+        return (doubled ? PAYOUT_SPLIT_DOUBLED_WIN : PAYOUT_SPLIT_WIN) + base;
+    }
+    return (doubled ? PAYOUT_DOUBLED_WIN : PAYOUT_WIN) + base;
+}
+
+void payout_table_record_hand(PayoutTable* table, HandOutcome outcome, bool doubled, bool split) {
+    table->hands[payout_category(outcome, doubled, split)]++;
+}
+
+void payout_table_record_round(PayoutTable* table, double round_result, bool natural, bool dealer_ace, bool dealer_natural) {
+    // A natural's whole result is its payout, which the variant supplies
+    double result = natural ? 0.0 : round_result;
+    table->rounds++;
+    table->result_squared += result * result;
+
+    if (dealer_ace && dealer_natural) {
+        table->insurance_wins++;
+        table->insurance_win_result += result;
+    } else if (dealer_ace) {
+        table->insurance_losses++;
+        table->insurance_loss_result += result;
+        table->naturals_insurance_lost += natural;
+    }
+}
+
+void payout_table_add(PayoutTable* total, const PayoutTable* table) {
+    for (int c = 0; c < PAYOUT_NUM_CATEGORIES; c++) {
+        total->hands[c] += table->hands[c];
+    }
+    total->rounds += table->rounds;
+    total->result_squared += table->result_squared;
+    total->insurance_wins += table->insurance_wins;
+    total->insurance_losses += table->insurance_losses;
+    total->insurance_win_result += table->insurance_win_result;
+    total->insurance_loss_result += table->insurance_loss_result;
+    total->naturals_insurance_lost += table->naturals_insurance_lost;
+}
+
+void payout_variant_from_rules(PayoutVariant* variant, const Rules* rules) {
+    variant->blackjack_payout = rules->blackjack_payout;
+    variant->insurance_payout = rules->insurance_payout;
+    variant->insure = false;
+}
+
+// Each round's result is its base result r plus b on a natural plus i on an
+// insured round, so the sums of r and r^2 kept by the table, plus the cross
+// terms it counts, give the mean and variance under any payouts
+void payout_score(const PayoutTable* table, const PayoutVariant* variant, PayoutScore* score) {
+    score->ev = 0.0;
+    score->standard_error = 0.0;
+    score->insurance_ev = 0.0;
+
+    long insured = table->insurance_wins + table->insurance_losses;
+    if (insured > 0) {
+        score->insurance_ev = (variant->insurance_payout * table->insurance_wins - table->insurance_losses) / insured;
+    }
+    if (table->rounds == 0) {
+        return;
+    }
+
+    double natural = variant->blackjack_payout;
+    long naturals = table->hands[PAYOUT_NATURAL];
+    double sum = naturals * natural;
+    for (int c = 0; c < PAYOUT_NUM_CATEGORIES; c++) {
+        sum += table->hands[c] * category_results[c];
+    }
+    double sum_squared = table->result_squared + naturals * natural * natural;
+
+    if (variant->insure) {
+        double win = INSURANCE_FRACTION * variant->insurance_payout;
+        double loss = -INSURANCE_FRACTION;
+        sum += table->insurance_wins * win + table->insurance_losses * loss;
+        sum_squared += table->insurance_wins * win * win + table->insurance_losses * loss * loss +
+                       2.0 * (win * table->insurance_win_result + loss * table->insurance_loss_result) +
+                       2.0 * natural * loss * table->naturals_insurance_lost;
+    }
+
+    long rounds = table->rounds;
+    score->ev = sum / rounds;
+    if (rounds > 1) {
+        double variance = (sum_squared / rounds - score->ev * score->ev) * rounds / (rounds - 1);
+        score->standard_error = sqrt(variance > 0 ? variance / rounds : 0.0);
+    }
+}
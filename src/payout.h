@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include "game.h"
+#include "rules.h"
+
+// What each hand of a round came to, in categories whose net result per
+// initial bet doesn't depend on the payout rules, except naturals, which are
+// paid blackjack_payout. Play never depends on blackjack_payout or
+// insurance_payout, so one run's table scores every payout variant.
+typedef enum {
+    PAYOUT_NATURAL,
+    PAYOUT_WIN,
+    PAYOUT_PUSH,
+    PAYOUT_LOSE,
+    PAYOUT_DOUBLED_WIN,
+    PAYOUT_DOUBLED_PUSH,
+    PAYOUT_DOUBLED_LOSE,
+    PAYOUT_SPLIT_WIN,
+    PAYOUT_SPLIT_PUSH,
+    PAYOUT_SPLIT_LOSE,
+    PAYOUT_SPLIT_DOUBLED_WIN,
+    PAYOUT_SPLIT_DOUBLED_PUSH,
+    PAYOUT_SPLIT_DOUBLED_LOSE,
+    PAYOUT_SURRENDER,
+    PAYOUT_NUM_CATEGORIES
+} PayoutCategory;
+
+// Counts and sums are exact (whole half units), so tables merged in any
+// order compare equal
+typedef struct {
+    long hands[PAYOUT_NUM_CATEGORIES];
+    long rounds;
+    double result_squared;           // Sum over rounds of (result less any natural's payout)^2
+    long insurance_wins;             // Dealer showed an ace and had blackjack
+    long insurance_losses;           // Dealer showed an ace without blackjack
+    double insurance_win_result;     // Sum of those rounds' results, as result_squared
+    double insurance_loss_result;
+    long naturals_insurance_lost;    // Naturals against an ace without blackjack
+} PayoutTable;
+
+typedef struct {
+    double blackjack_payout;
+    double insurance_payout;
+    bool insure;                     // Insure half the bet whenever the dealer shows an ace
+} PayoutVariant;
+
+typedef struct {
+    double ev;                       // Per round, in units of the initial bet
+    double standard_error;
+    double insurance_ev;             // Per unit insured, whether or not the variant insures
+} PayoutScore;
+
+const char* payout_category_name(PayoutCategory category);
+
+PayoutCategory payout_category(HandOutcome outcome, bool doubled, bool split);
+
+void payout_table_record_hand(PayoutTable* table, HandOutcome outcome, bool doubled, bool split);
+
+// After the round's hands: round_result is per initial bet, as dealt
+void payout_table_record_round(PayoutTable* table, double round_result, bool natural, bool dealer_ace, bool dealer_natural);
+
+void payout_table_add(PayoutTable* total, const PayoutTable* table);
+
+void payout_variant_from_rules(PayoutVariant* variant, const Rules* rules);
+
+void payout_score(const PayoutTable* table, const PayoutVariant* variant, PayoutScore* score);
@@ -0,0 +1,494 @@
+#define _GNU_SOURCE  // CPU affinity: cpu_set_t, sched_getaffinity, pthread_attr_setaffinity_np
+
+#include "pool.h"
+#include "lanes.h"
+#include "deck.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define POOL_MAX_NODES 64
+#define NODE_CPULIST "/sys/devices/system/node/node%d/cpulist"
+
+struct PoolTask {
+    int job;
+    int first_round;
+    int num_rounds;
+    uint64_t first_shoe;
+};
+
+// Task indices; the owner pops from the tail, thieves take from the head
+typedef struct {
+    pthread_mutex_t lock;
+    int* tasks;
+    int capacity;
+    int head;
+    int tail;
+} PoolDeque;
+
+// Owned by the worker running the task: written once when the task ends,
+// then only read by the merge
+struct PoolSlot {
+    _Alignas(POOL_CACHE_LINE) SimulationResults results;
+};
+
+// Allocated and first touched by the worker thread itself, once it runs where
+// it was pinned, so the kernel places its tallies, shoes and games on the
+// worker's NUMA node
+typedef struct {
+    SimulationResults results;  // The running task's tallies
+    SimulationContext context;  // Shoes and games reused by every task this worker runs
+} PoolWorkerLocal;
+
+// The deque is the only part other workers touch. Everything after it starts
+// on a fresh cache line and is written by this worker alone, so the tallies
+// of a running task never share a line with another worker's.
+struct PoolWorker {
+    PoolDeque deque;
+    _Alignas(POOL_CACHE_LINE) PoolWorkerLocal* local;
+    Pool* pool;
+    int index;
+    long tasks_run;
+    long tasks_stolen;
+    bool pinned;
+    cpu_set_t cpus;
+    pthread_t thread;
+};
+
+_Static_assert(sizeof(PoolSlot) % POOL_CACHE_LINE == 0, "task slots must not share cache lines");
+_Static_assert(sizeof(PoolWorker) % POOL_CACHE_LINE == 0, "workers must not share cache lines");
+_Static_assert(_Alignof(PoolWorkerLocal) <= POOL_CACHE_LINE, "PoolWorkerLocal is allocated cache-line aligned");
+
+static bool counting_job(const SimulationConfig* config) {
+    return config->count_systems != NULL && config->num_count_systems > 0;
+}
+
+static int deque_pop(PoolDeque* deque) {
+    int task = -1;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail > deque->head) {
+        task = deque->tasks[--deque->tail];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return task;
+}
+
+static int deque_steal(PoolDeque* deque) {
+    int task = -1;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail > deque->head) {
+        task = deque->tasks[deque->head++];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return task;
+}
+
+// Tasks never spawn tasks, so once every deque is empty the run is over
+static int steal_task(Pool* pool, int thief) {
+    for (int i = 1; i < pool->num_threads; i++) {
+        int task = deque_steal(&pool->workers[(thief + i) % pool->num_threads].deque);
+        if (task >= 0) {
+            return task;
+        }
+    }
+    return -1;
+}
+
+// Pairwise over the job's slots in task order. The tree's shape depends only
+// on the number of tasks, so the sums don't depend on who ran what.
+static void merge_job(Pool* pool, PoolJob* job) {
+    PoolSlot* slots = &pool->task_results[job->first_task];
+    for (int stride = 1; stride < job->num_tasks; stride *= 2) {
+        for (int k = 0; k + stride < job->num_tasks; k += 2 * stride) {
+            simulation_results_add(&slots[k].results, &slots[k + stride].results, job->config.num_count_systems);
+        }
+    }
+    job->results = slots[0].results;
+
+    if (pool->job_done != NULL) {
+        pool->job_done(pool, (int)(job - pool->jobs), pool->job_done_context);
+    }
+}
+
+static void run_task(PoolWorker* worker, int index) {
+    Pool* pool = worker->pool;
+    const PoolTask* task = &pool->tasks[index];
+    PoolJob* job = &pool->jobs[task->job];
+    SimulationConfig config = job->config;
+    config.num_hands = task->num_rounds;
+    config.first_shoe = task->first_shoe;
+
+    PoolWorkerLocal* local = worker->local;
+    memset(&local->results, 0, sizeof(local->results));
+    lanes_run_in(&local->context, &config, &local->results);
+    pool->task_results[index].results = local->results;
+
+    // The decrement publishes the slot; the last task's worker sees them all
+    if (atomic_fetch_sub(&job->tasks_left, 1) == 1) {
+        merge_job(pool, job);
+    }
+}
+
+static void run_tasks(PoolWorker* worker) {
+    for (;;) {
+        int task = deque_pop(&worker->deque);
+        if (task < 0) {
+            task = steal_task(worker->pool, worker->index);
+            if (task < 0) {
+                return;
+            }
+            worker->tasks_stolen++;
+        }
+        run_task(worker, task);
+        worker->tasks_run++;
+    }
+}
+
+static void* pool_worker(void* arg) {
+    PoolWorker* worker = arg;
+    Pool* pool = worker->pool;
+    unsigned long generation = 0;
+
+    // A worker that can't get its storage runs nothing; the others steal its
+    // share, and pool_run reports a run nobody could finish
+    size_t local_size = (sizeof(PoolWorkerLocal) + POOL_CACHE_LINE - 1) / POOL_CACHE_LINE * POOL_CACHE_LINE;
+    worker->local = aligned_alloc(POOL_CACHE_LINE, local_size);
+    if (worker->local != NULL) {
+        memset(worker->local, 0, local_size);
+        simulation_context_init(&worker->local->context);
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == generation && !pool->stopping) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stopping) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (worker->local != NULL) {
+            run_tasks(worker);
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->workers_busy == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    if (worker->local != NULL) {
+        simulation_context_destroy(&worker->local->context);
+        free(worker->local);
+    }
+    return NULL;
+}
+
+// "0-3,8-11" style lists, as sysfs prints them
+static void parse_cpulist(const char* text, cpu_set_t* cpus) {
+    CPU_ZERO(cpus);
+    const char* p = text;
+    while (*p >= '0' && *p <= '9') {
+        char* end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, cpus);
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+}
+
+// The CPUs of each NUMA node this process may run on. Without sysfs node
+// information everything is one node.
+static int read_nodes(cpu_set_t* nodes, const cpu_set_t* allowed) {
+    int num_nodes = 0;
+    for (int node = 0; node < POOL_MAX_NODES; node++) {
+        char path[64];
+        snprintf(path, sizeof(path), NODE_CPULIST, node);
+        FILE* file = fopen(path, "r");
+        if (file == NULL) {
+            continue;
+        }
+
+        char text[4096];
+        bool read = fgets(text, sizeof(text), file) != NULL;
+        fclose(file);
+        if (!read) {
+            continue;
+        }
+
+        parse_cpulist(text, &nodes[num_nodes]);
+        CPU_AND(&nodes[num_nodes], &nodes[num_nodes], allowed);
+        if (CPU_COUNT(&nodes[num_nodes]) > 0) {  // Memory-only nodes have no CPUs to pin to
+            num_nodes++;
+        }
+    }
+
+    if (num_nodes == 0) {
+        nodes[0] = *allowed;
+        num_nodes = 1;
+    }
+    return num_nodes;
+}
+
+int pool_num_nodes(void) {
+    cpu_set_t allowed;
+    cpu_set_t nodes[POOL_MAX_NODES];
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return 1;
+    }
+    return read_nodes(nodes, &allowed);
+}
+
+// Cores: worker w on the w-th CPU the process may use, filling one socket
+// before the next where CPUs are numbered by socket. Nodes: worker w anywhere
+// on node w mod the number of nodes, spreading workers across sockets.
+static void assign_cpus(Pool* pool) {
+    cpu_set_t allowed;
+    if (pool->pinning == POOL_PIN_NONE || sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+
+    cpu_set_t nodes[POOL_MAX_NODES];
+    int num_nodes = read_nodes(nodes, &allowed);
+    int cpus[CPU_SETSIZE];
+    int num_cpus = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpus[num_cpus++] = cpu;
+        }
+    }
+
+    for (int w = 0; w < pool->num_threads; w++) {
+        PoolWorker* worker = &pool->workers[w];
+        worker->pinned = true;
+        if (pool->pinning == POOL_PIN_NODES) {
+            worker->cpus = nodes[w % num_nodes];
+        } else {
+            CPU_ZERO(&worker->cpus);
+            CPU_SET(cpus[w % num_cpus], &worker->cpus);
+        }
+    }
+}
+
+bool pool_init(Pool* pool, int num_threads) {
+    return pool_init_pinned(pool, num_threads, POOL_PIN_NONE);
+}
+
+bool pool_init_pinned(Pool* pool, int num_threads, PoolPinning pinning) {
+    memset(pool, 0, sizeof(*pool));
+    if (num_threads <= 0) {
+        num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    pool->num_threads = num_threads > 0 ? num_threads : 1;
+    pool->pinning = pinning;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->workers = aligned_alloc(POOL_CACHE_LINE, sizeof(PoolWorker) * pool->num_threads);
+    if (pool->workers == NULL) {
+        pool->num_threads = 0;
+        return false;
+    }
+    memset(pool->workers, 0, sizeof(PoolWorker) * pool->num_threads);
+    assign_cpus(pool);
+
+    // Pinned before they start, so each worker's first allocation is already local
+    int started = 0;
+    for (int w = 0; w < pool->num_threads; w++) {
+        PoolWorker* worker = &pool->workers[w];
+        worker->pool = pool;
+        worker->index = w;
+        pthread_mutex_init(&worker->deque.lock, NULL);
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        if (worker->pinned) {
+            pthread_attr_setaffinity_np(&attributes, sizeof(worker->cpus), &worker->cpus);
+        }
+        int error = pthread_create(&worker->thread, &attributes, pool_worker, worker);
+        pthread_attr_destroy(&attributes);
+        if (error != 0) {
+            pthread_mutex_destroy(&worker->deque.lock);
+            break;
+        }
+        started++;
+    }
+
+    // Workers only read num_threads during a run, so shrinking it here is safe
+    pool->num_threads = started;
+    return started > 0;
+}
+
+int pool_add_job(Pool* pool, const SimulationConfig* config, int rounds_per_task) {
+    if (config->seed == 0 || config->num_hands <= 0) {
+        return -1;
+    }
+
+    if (pool->num_jobs == pool->capacity) {
+        int capacity = pool->capacity > 0 ? pool->capacity * 2 : 16;
+        PoolJob* jobs = realloc(pool->jobs, sizeof(PoolJob) * capacity);
+        if (jobs == NULL) {
+            return -1;
+        }
+        pool->jobs = jobs;
+        pool->capacity = capacity;
+    }
+
+    PoolJob* job = &pool->jobs[pool->num_jobs];
+    memset(job, 0, sizeof(*job));
+    job->config = *config;
+    job->rounds_per_task = rounds_per_task > 0 ? rounds_per_task : POOL_DEFAULT_ROUNDS_PER_TASK;
+    job->num_tasks = (config->num_hands + job->rounds_per_task - 1) / job->rounds_per_task;
+    return pool->num_jobs++;
+}
+
+SimulationResults* pool_job_results(Pool* pool, int job) {
+    return &pool->jobs[job].results;
+}
+
+// Task and deque storage only ever grows, so repeated runs of similar size
+// don't allocate
+static bool reserve_tasks(Pool* pool, int num_tasks) {
+    if (num_tasks > pool->task_capacity) {
+        PoolTask* tasks = realloc(pool->tasks, sizeof(PoolTask) * num_tasks);
+        if (tasks == NULL) {
+            return false;
+        }
+        pool->tasks = tasks;
+
+        PoolSlot* task_results = aligned_alloc(POOL_CACHE_LINE, sizeof(PoolSlot) * num_tasks);
+        if (task_results == NULL) {
+            return false;
+        }
+        free(pool->task_results);
+        pool->task_results = task_results;
+        pool->task_capacity = num_tasks;
+    }
+
+    int per_worker = num_tasks / pool->num_threads + 1;
+    for (int w = 0; w < pool->num_threads; w++) {
+        PoolDeque* deque = &pool->workers[w].deque;
+        if (per_worker > deque->capacity) {
+            int* deque_tasks = realloc(deque->tasks, sizeof(int) * per_worker);
+            if (deque_tasks == NULL) {
+                return false;
+            }
+            deque->tasks = deque_tasks;
+            deque->capacity = per_worker;
+        }
+        deque->head = 0;
+        deque->tail = 0;
+    }
+    return true;
+}
+
+bool pool_run(Pool* pool) {
+    pool->tasks_run = 0;
+    pool->tasks_stolen = 0;
+
+    pool->num_tasks = 0;
+    for (int j = 0; j < pool->num_jobs; j++) {
+        pool->jobs[j].first_task = pool->num_tasks;
+        pool->num_tasks += pool->jobs[j].num_tasks;
+    }
+    if (pool->num_tasks == 0) {
+        return true;
+    }
+    if (pool->num_threads == 0 || !reserve_tasks(pool, pool->num_tasks)) {
+        return false;
+    }
+
+    for (int j = 0; j < pool->num_jobs; j++) {
+        PoolJob* job = &pool->jobs[j];
+        atomic_init(&job->tasks_left, job->num_tasks);
+        for (int k = 0; k < job->num_tasks; k++) {
+            PoolTask* task = &pool->tasks[job->first_task + k];
+            task->job = j;
+            task->first_round = k * job->rounds_per_task;
+            task->num_rounds = job->config.num_hands - task->first_round;
+            if (task->num_rounds > job->rounds_per_task) {
+                task->num_rounds = job->rounds_per_task;
+            }
+            task->first_shoe = counting_job(&job->config)
+                                   ? job->config.first_shoe + (uint64_t)k * DECK_SHOES_PER_INIT
+                                   : job->config.first_shoe + (uint64_t)task->first_round;
+        }
+    }
+
+    // Dealt round robin, so every worker starts with a share of every job
+    for (int t = 0; t < pool->num_tasks; t++) {
+        PoolDeque* deque = &pool->workers[t % pool->num_threads].deque;
+        deque->tasks[deque->tail++] = t;
+    }
+    for (int w = 0; w < pool->num_threads; w++) {
+        pool->workers[w].tasks_run = 0;
+        pool->workers[w].tasks_stolen = 0;
+    }
+
+    // Workers merge each job as its last task finishes, so once they are all
+    // idle every job's results are in place
+    pthread_mutex_lock(&pool->lock);
+    pool->workers_busy = pool->num_threads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    while (pool->workers_busy > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int w = 0; w < pool->num_threads; w++) {
+        pool->tasks_run += pool->workers[w].tasks_run;
+        pool->tasks_stolen += pool->workers[w].tasks_stolen;
+    }
+    return pool->tasks_run == pool->num_tasks;
+}
+
+bool pool_simulate(Pool* pool, const SimulationConfig* config, int rounds_per_task, SimulationResults* results) {
+    pool_clear(pool);
+    int job = pool_add_job(pool, config, rounds_per_task);
+    if (job < 0 || !pool_run(pool)) {
+        memset(results, 0, sizeof(*results));
+        return false;
+    }
+    *results = pool->jobs[job].results;
+    return true;
+}
+
+void pool_clear(Pool* pool) {
+    pool->num_jobs = 0;
+}
+
+void pool_destroy(Pool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int w = 0; w < pool->num_threads; w++) {
+        pthread_join(pool->workers[w].thread, NULL);
+        pthread_mutex_destroy(&pool->workers[w].deque.lock);
+        free(pool->workers[w].deque.tasks);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+
+    free(pool->workers);
+    free(pool->tasks);
+    free(pool->task_results);
+    free(pool->jobs);
+    memset(pool, 0, sizeof(*pool));
+}
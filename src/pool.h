@@ -0,0 +1,94 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "simulation.h"
+
+#define POOL_DEFAULT_ROUNDS_PER_TASK 65536
+#define POOL_CACHE_LINE 64
+
+// One simulation split into tasks of rounds_per_task rounds. Every task deals
+// shoes fixed by the job's seed and the task's place in the job, so the
+// results don't depend on which thread runs it or when:
+//   - fresh-shoe jobs: a task starting at round r deals shoes first_shoe + r...,
+//     the same shoes a single run of the whole job would deal
+//   - counting jobs: task k carries its own shoe sequence from shoe
+//     first_shoe + k * DECK_SHOES_PER_INIT, like a benchmark batch
+typedef struct {
+    SimulationConfig config;     // num_hands covers the whole job; seed must be nonzero
+    int rounds_per_task;
+    int first_task;              // Index of the job's first task in the run
+    int num_tasks;
+    atomic_int tasks_left;       // During a run; whoever finishes the last task merges the job
+    SimulationResults results;   // All tasks, merged pairwise in task order, once pool_run returns
+} PoolJob;
+
+typedef enum {
+    POOL_PIN_NONE,   // The scheduler places and moves threads
+    POOL_PIN_CORES,  // Worker w on the w-th CPU the process may use
+    POOL_PIN_NODES   // Worker w on NUMA node w mod nodes, free to move within it
+} PoolPinning;
+
+typedef struct PoolTask PoolTask;
+typedef struct PoolWorker PoolWorker;
+typedef struct PoolSlot PoolSlot;
+
+// Work-stealing pool. Each worker starts a run with its share of every job's
+// tasks in its own deque and runs them newest first; a worker that runs dry
+// takes the oldest task of another worker's deque, so a few expensive jobs
+// don't leave the other cores idle.
+//
+// The worker threads and their SimulationContexts live from pool_init to
+// pool_destroy, so callers that simulate thousands of small jobs pay for
+// threads, shoes and games once. pool_clear drops finished jobs between runs.
+typedef struct Pool Pool;
+
+struct Pool {
+    PoolJob* jobs;
+    int num_jobs;
+    int capacity;
+    int num_threads;             // Workers pool_init actually started
+    PoolPinning pinning;
+    long tasks_run;              // Last pool_run
+    long tasks_stolen;           // Last pool_run: tasks run by a worker other than the one dealt them
+    void (*job_done)(Pool* pool, int job, void* context);  // Optional: called by whichever worker merges a job
+    void* job_done_context;
+
+    PoolWorker* workers;
+    PoolTask* tasks;             // Current run, in job order
+    PoolSlot* task_results;      // One cache-line aligned block per task
+    int num_tasks;
+    int task_capacity;
+    pthread_mutex_t lock;
+    pthread_cond_t start;        // A run is ready, or the pool is shutting down
+    pthread_cond_t done;         // The last busy worker finished
+    unsigned long generation;    // Runs started so far
+    int workers_busy;
+    bool stopping;
+};
+
+// num_threads <= 0 = one per online CPU. If some threads can't be started,
+// the pool runs on those that did; false if none did. Either way the pool
+// must be destroyed.
+bool pool_init(Pool* pool, int num_threads);
+
+bool pool_init_pinned(Pool* pool, int num_threads, PoolPinning pinning);
+
+int pool_num_nodes(void);
+
+// Returns the job's index, or -1 if the job has no seed or no rounds
+int pool_add_job(Pool* pool, const SimulationConfig* config, int rounds_per_task);
+
+// false if the run couldn't be set up or some task went unrun (no workers,
+// or none with the memory to run one); job results are then not valid
+bool pool_run(Pool* pool);
+
+// Runs config as the pool's only job and copies out its results, zeroed on failure
+bool pool_simulate(Pool* pool, const SimulationConfig* config, int rounds_per_task, SimulationResults* results);
+
+SimulationResults* pool_job_results(Pool* pool, int job);
+
+void pool_clear(Pool* pool);
+
+void pool_destroy(Pool* pool);
@@ -0,0 +1,224 @@
+#include "rng.h"
+#include "cpu.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RNG_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#define PHILOX_ROUNDS 10
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u  // Golden ratio
+#define PHILOX_W1 0xBB67AE85u  // sqrt(3) - 1
+
+void rng_philox(const uint32_t counter[RNG_BLOCK_WORDS], const uint32_t key[2], uint32_t output[RNG_BLOCK_WORDS]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        uint64_t product0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t product1 = (uint64_t)PHILOX_M1 * c2;
+
+        c0 = (uint32_t)(product1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)product1;
+        c2 = (uint32_t)(product0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)product0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+}
+
+// Philox on RNG_LANES consecutive blocks at once, one block per 64-bit lane.
+// Lanes hold 32-bit words zero-extended to 64 bits, so on x86 each multiply is
+// one vpmuludq. The outputs are packed back into block order, so every kernel
+// fills the buffer exactly like rng_philox would.
+#ifdef RNG_X86_KERNELS
+
+__attribute__((target("avx512f")))
+static void philox_lanes_avx512(const RngStream* rng, uint64_t first_block, uint32_t* out) {
+    const __m512i low_word = _mm512_set1_epi64(0xFFFFFFFF);
+    __m512i block = _mm512_add_epi64(_mm512_set1_epi64((long long)first_block), _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+    __m512i c0 = _mm512_and_si512(block, low_word);
+    __m512i c1 = _mm512_srli_epi64(block, 32);
+    __m512i c2 = _mm512_set1_epi64(rng->stream & 0xFFFFFFFF);
+    __m512i c3 = _mm512_set1_epi64(rng->stream >> 32);
+    const __m512i m0 = _mm512_set1_epi64(PHILOX_M0);
+    const __m512i m1 = _mm512_set1_epi64(PHILOX_M1);
+
+    uint32_t k0 = rng->key[0], k1 = rng->key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        __m512i product0 = _mm512_mul_epu32(c0, m0);
+        __m512i product1 = _mm512_mul_epu32(c2, m1);
+
+        c0 = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(product1, 32), c1), _mm512_set1_epi64(k0));
+        c1 = _mm512_and_si512(product1, low_word);
+        c2 = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(product0, 32), c3), _mm512_set1_epi64(k1));
+        c3 = _mm512_and_si512(product0, low_word);
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    // Words 0-1 and 2-3 of each block as one 64-bit lane each, then
+    // interleave the halves so blocks land in order
+    __m512i words01 = _mm512_or_si512(c0, _mm512_slli_epi64(c1, 32));
+    __m512i words23 = _mm512_or_si512(c2, _mm512_slli_epi64(c3, 32));
+    __m512i even_blocks = _mm512_unpacklo_epi64(words01, words23);
+    __m512i odd_blocks = _mm512_unpackhi_epi64(words01, words23);
+    _mm512_storeu_si512(out, _mm512_permutex2var_epi64(even_blocks, _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11), odd_blocks));
+    _mm512_storeu_si512(out + 16, _mm512_permutex2var_epi64(even_blocks, _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15), odd_blocks));
+}
+
+// Two groups of four blocks, interleaved so the multiplies overlap
+__attribute__((target("avx2")))
+static void philox_lanes_avx2(const RngStream* rng, uint64_t first_block, uint32_t* out) {
+    const __m256i low_word = _mm256_set1_epi64x(0xFFFFFFFF);
+    const __m256i m0 = _mm256_set1_epi64x(PHILOX_M0);
+    const __m256i m1 = _mm256_set1_epi64x(PHILOX_M1);
+    __m256i c0[2], c1[2], c2[2], c3[2];
+
+    for (int g = 0; g < 2; g++) {
+        __m256i block = _mm256_add_epi64(_mm256_set1_epi64x((long long)first_block), _mm256_setr_epi64x(4 * g, 4 * g + 1, 4 * g + 2, 4 * g + 3));
+        c0[g] = _mm256_and_si256(block, low_word);
+        c1[g] = _mm256_srli_epi64(block, 32);
+        c2[g] = _mm256_set1_epi64x(rng->stream & 0xFFFFFFFF);
+        c3[g] = _mm256_set1_epi64x(rng->stream >> 32);
+    }
+
+    uint32_t k0 = rng->key[0], k1 = rng->key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        __m256i key0 = _mm256_set1_epi64x(k0);
+        __m256i key1 = _mm256_set1_epi64x(k1);
+        for (int g = 0; g < 2; g++) {
+            __m256i product0 = _mm256_mul_epu32(c0[g], m0);
+            __m256i product1 = _mm256_mul_epu32(c2[g], m1);
+
+            c0[g] = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), c1[g]), key0);
+            c1[g] = _mm256_and_si256(product1, low_word);
+            c2[g] = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), c3[g]), key1);
+            c3[g] = _mm256_and_si256(product0, low_word);
+        }
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    for (int g = 0; g < 2; g++) {
+        __m256i words01 = _mm256_or_si256(c0[g], _mm256_slli_epi64(c1[g], 32));
+        __m256i words23 = _mm256_or_si256(c2[g], _mm256_slli_epi64(c3[g], 32));
+        __m256i even_blocks = _mm256_unpacklo_epi64(words01, words23);
+        __m256i odd_blocks = _mm256_unpackhi_epi64(words01, words23);
+        _mm256_storeu_si256((__m256i*)(out + 16 * g), _mm256_permute2x128_si256(even_blocks, odd_blocks, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 16 * g + 8), _mm256_permute2x128_si256(even_blocks, odd_blocks, 0x31));
+    }
+}
+
+#endif
+
+// Without wide widening multiplies, lanes of 64-bit products cost more than
+// they save: run the scalar rounds block by block
+static void philox_lanes_scalar(const RngStream* rng, uint64_t first_block, uint32_t* out) {
+    for (int lane = 0; lane < RNG_LANES; lane++) {
+        uint64_t block = first_block + lane;
+        uint32_t counter[RNG_BLOCK_WORDS] = {
+            (uint32_t)block, (uint32_t)(block >> 32), (uint32_t)rng->stream, (uint32_t)(rng->stream >> 32)
+        };
+        rng_philox(counter, rng->key, &out[lane * RNG_BLOCK_WORDS]);
+    }
+}
+
+
+typedef void (*PhiloxKernel)(const RngStream* rng, uint64_t first_block, uint32_t* out);
+
+static PhiloxKernel philox_kernel(void) {
+#ifdef RNG_X86_KERNELS
+    switch (cpu_level()) {
+        case CPU_LEVEL_AVX512:
+            return philox_lanes_avx512;
+        case CPU_LEVEL_AVX2:
+            return philox_lanes_avx2;
+        default:
+            break;
+    }
+#endif
+    return philox_lanes_scalar;
+}
+
+// The 64-bit seed is the key; the counter is (block, stream), 64 bits each
+void rng_stream_init(RngStream* rng, uint64_t seed, uint64_t stream) {
+    rng->key[0] = (uint32_t)seed;
+    rng->key[1] = (uint32_t)(seed >> 32);
+    rng->stream = stream;
+    rng->block = 0;
+    rng->filled = 0;
+    rng->used = 0;
+}
+
+// Blocks come out in counter order whatever the batch size, so a stream's
+// words never depend on how it was buffered
+void rng_refill(RngStream* rng) {
+    if (rng->block == 0) {
+        for (int b = 0; b < RNG_FIRST_FILL_BLOCKS; b++) {
+            uint32_t counter[RNG_BLOCK_WORDS] = {
+                (uint32_t)b, 0, (uint32_t)rng->stream, (uint32_t)(rng->stream >> 32)
+            };
+            rng_philox(counter, rng->key, &rng->buffer[b * RNG_BLOCK_WORDS]);
+        }
+        rng->block = RNG_FIRST_FILL_BLOCKS;
+        rng->filled = RNG_FIRST_FILL_BLOCKS * RNG_BLOCK_WORDS;
+    } else {
+        PhiloxKernel kernel = philox_kernel();
+        for (int b = 0; b < RNG_BUFFER_BLOCKS; b += RNG_LANES) {
+            kernel(rng, rng->block + b, &rng->buffer[b * RNG_BLOCK_WORDS]);
+        }
+        rng->block += RNG_BUFFER_BLOCKS;
+        rng->filled = RNG_BUFFER_WORDS;
+    }
+
+    rng->used = 0;
+}
+
+uint64_t rng_tell(const RngStream* rng) {
+    return rng->block * RNG_BLOCK_WORDS - rng->filled + rng->used;
+}
+
+// Within the buffer this is just moving the read index; anywhere else the
+// buffer is regenerated from the word's block, which gives the same words
+void rng_seek(RngStream* rng, uint64_t word) {
+    uint64_t buffer_start = rng->block * RNG_BLOCK_WORDS - rng->filled;
+    if (word >= buffer_start && word <= rng->block * RNG_BLOCK_WORDS) {
+        rng->used = (int)(word - buffer_start);
+        return;
+    }
+
+    rng->block = word / RNG_BLOCK_WORDS;
+    rng_refill(rng);
+    rng->used = (int)(word - (rng->block * RNG_BLOCK_WORDS - rng->filled));
+}
+
+// Lemire's nearly divisionless method: a number in [0, max) from the high
+// half of a 32x32->64 product. Only draws landing in the low, biased sliver
+// pay for a division, about max / 2^32 of them.
+uint32_t rng_range(RngStream* rng, uint32_t max) {
+    if (max == 0) return 0;
+
+    uint64_t product = (uint64_t)rng_next(rng) * max;
+    uint32_t low = (uint32_t)product;
+
+    if (low < max) {
+        uint32_t threshold = -max % max;  // 2^32 mod max
+        while (low < threshold) {
+            product = (uint64_t)rng_next(rng) * max;
+            low = (uint32_t)product;
+        }
+    }
+
+    return (uint32_t)(product >> 32);
+}
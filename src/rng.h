@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+#define RNG_BLOCK_WORDS 4
+#define RNG_LANES 8                     // Blocks generated side by side, one per vector lane
+#define RNG_BUFFER_BLOCKS 16            // Two full vector passes per refill
+#define RNG_FIRST_FILL_BLOCKS 2         // A new stream starts small: most shoes in a fresh-shoe run use a few cards
+#define RNG_BUFFER_WORDS (RNG_BUFFER_BLOCKS * RNG_BLOCK_WORDS)
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+// Each output block is a pure function of (key, stream, block number), so any
+// part of any stream can be regenerated without replaying what came before.
+typedef struct {
+    uint32_t key[2];
+    uint64_t stream;
+    uint64_t block;                    // Next block to generate
+    uint32_t buffer[RNG_BUFFER_WORDS];
+    int filled;                        // Words in buffer
+    int used;                          // Words of buffer already handed out
+} RngStream;
+
+void rng_philox(const uint32_t counter[RNG_BLOCK_WORDS], const uint32_t key[2], uint32_t output[RNG_BLOCK_WORDS]);
+
+void rng_stream_init(RngStream* rng, uint64_t seed, uint64_t stream);
+
+void rng_refill(RngStream* rng);
+
+// Inline so the per-card paths pay one compare and one load per draw
+static inline uint32_t rng_next(RngStream* rng) {
+    if (rng->used == rng->filled) {
+        rng_refill(rng);
+    }
+
+    return rng->buffer[rng->used++];
+}
+
+uint32_t rng_range(RngStream* rng, uint32_t max);
+
+// Words handed out so far; rng_seek goes back (or forward) to any such point
+uint64_t rng_tell(const RngStream* rng);
+
+void rng_seek(RngStream* rng, uint64_t word);
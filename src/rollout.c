@@ -0,0 +1,76 @@
+#include <math.h>
+#include "rollout.h"
+
+// The rest of the round once action is played on hand_index: that hand if it
+// is still open, the hands after it, the dealer, and the payout
+static double play_out(GameState* game, SimulationConfig* config, int hand_index, PlayerAction action) {
+    game_play_action(game, action, hand_index);
+
+    bool still_open = (action == HIT || action == SPLIT) && hand_get_value(&game->player_hands[hand_index]) <= 21;
+    simulation_play_player_hands_from(game, config, NULL, still_open ? hand_index : hand_index + 1);
+    if (!game->surrendered && !simulation_all_hands_busted(game)) {
+        simulation_play_dealer(game);
+    }
+
+    // Everything staked on the round once it's over: insurance plus every
+    // hand's bet, doubled or split
+    double payout = game_resolve(game);
+    double staked = game->insurance_bet;
+    for (int h = 0; h < game->num_player_hands; h++) {
+        staked += game->player_bets[h];
+    }
+    return payout - staked;
+}
+
+bool rollout_action(GameState* game, SimulationConfig* config, int hand_index, PlayerAction action, int rollouts,
+                    RolloutResult* result) {
+    if (game->shoe->mode == DECK_SHUFFLE_FULL || !simulation_action_allowed(game, config, hand_index, action)) {
+        return false;
+    }
+
+    GameSnapshot snapshot;
+    game_snapshot_init(&snapshot, &game->rules);
+    game_snapshot_save(&snapshot, game);
+
+    for (int i = 0; i < rollouts; i++) {
+        deck_branch(game->shoe, i);
+        double net = play_out(game, config, hand_index, action);
+        result->rollouts++;
+        result->total += net;
+        result->total_squared += net * net;
+        game_snapshot_restore(&snapshot, game);
+    }
+
+    game_snapshot_destroy(&snapshot);
+    return true;
+}
+
+PlayerAction rollout_best_action(GameState* game, SimulationConfig* config, int hand_index, int rollouts,
+                                 RolloutResult results[ROLLOUT_NUM_ACTIONS]) {
+    PlayerAction best = STAND;
+    double best_ev = -INFINITY;
+    for (int a = 0; a < ROLLOUT_NUM_ACTIONS; a++) {
+        RolloutResult blank = {0};
+        results[a] = blank;
+        if (rollout_action(game, config, hand_index, (PlayerAction)a, rollouts, &results[a]) &&
+            rollout_get_ev(&results[a]) > best_ev) {
+            best = (PlayerAction)a;
+            best_ev = rollout_get_ev(&results[a]);
+        }
+    }
+    return best;
+}
+
+double rollout_get_ev(const RolloutResult* result) {
+    return result->rollouts > 0 ? result->total / result->rollouts : 0.0;
+}
+
+double rollout_get_standard_error(const RolloutResult* result) {
+    long n = result->rollouts;
+    if (n < 2) {
+        return 0.0;
+    }
+    double mean = result->total / n;
+    double variance = (result->total_squared / n - mean * mean) * n / (n - 1);
+    return sqrt(variance > 0 ? variance / n : 0.0);
+}
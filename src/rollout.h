@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+#include "simulation.h"
+
+#define ROLLOUT_NUM_ACTIONS 5  // HIT, STAND, DOUBLE, SPLIT, SURRENDER
+
+// "What if I hit here?" answered by playing the round out many times from
+// one GameState. The state is snapshotted once; each rollout restores it,
+// branches the shoe so the cards still to come differ, plays the action and
+// then the rest of the round by config's strategy. Rollout i of every action
+// deals from the same branch, so differences between actions are paired.
+// The dealer's hole card is part of the state, as dealt.
+typedef struct {
+    long rollouts;
+    double total;          // Net round results, in the units of the bets
+    double total_squared;
+} RolloutResult;
+
+// false (and nothing played) when the shoe was fully shuffled up front, which
+// leaves no cards to vary, or the action isn't legal on the hand. The game
+// is left as it was given.
+bool rollout_action(GameState* game, SimulationConfig* config, int hand_index, PlayerAction action, int rollouts,
+                    RolloutResult* result);
+
+// Every legal action, results indexed by PlayerAction (rollouts 0 for the
+// rest); returns the best, or STAND if none could be rolled out
+PlayerAction rollout_best_action(GameState* game, SimulationConfig* config, int hand_index, int rollouts,
+                                 RolloutResult results[ROLLOUT_NUM_ACTIONS]);
+
+double rollout_get_ev(const RolloutResult* result);
+
+double rollout_get_standard_error(const RolloutResult* result);
@@ -31,4 +31,22 @@ void rules_init(Rules* rules) {
     // Rare rules
     rules->five_card_charlie = false;          // Not standard
     rules->six_card_charlie = false;           // Not standard
-}
\ No newline at end of file
+}
+
+// Play and the cards dealt depend on every rule but the payouts
+bool rules_same_play(const Rules* a, const Rules* b) {
+    return a->dealer_hits_soft_17 == b->dealer_hits_soft_17 &&
+           a->dealer_peeks_blackjack == b->dealer_peeks_blackjack &&
+           a->european_no_hole_card == b->european_no_hole_card &&
+           a->double_after_split == b->double_after_split &&
+           a->can_resplit_aces == b->can_resplit_aces &&
+           a->can_hit_split_aces == b->can_hit_split_aces &&
+           a->late_surrender_allowed == b->late_surrender_allowed &&
+           a->early_surrender_allowed == b->early_surrender_allowed &&
+           a->double_any_two_cards == b->double_any_two_cards &&
+           a->max_splits == b->max_splits &&
+           a->num_decks == b->num_decks &&
+           a->shoe_penetration == b->shoe_penetration &&
+           a->five_card_charlie == b->five_card_charlie &&
+           a->six_card_charlie == b->six_card_charlie;
+}
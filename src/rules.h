@@ -34,4 +34,7 @@ typedef struct {
     bool six_card_charlie;
 } Rules;
 
-void rules_init(Rules* rules);
\ No newline at end of file
+void rules_init(Rules* rules);
+
+// True when a and b differ at most in blackjack_payout and insurance_payout
+bool rules_same_play(const Rules* a, const Rules* b);
@@ -1,6 +1,7 @@
 #include "simulation.h"
 #include "game.h"
 #include "card.h"
+#include <math.h>
 #include <stdio.h>
 
 bool can_split(Rules *rules, int curr_player_hands, bool split_aces)
@@ -33,154 +34,557 @@ bool can_double(Rules *rules, PlayerAction curr_player_action, int cards_in_hand
     return true;
 }
 
-void simulation_run(SimulationConfig *simulation_config, SimulationResults *simulation_results)
+// What the rules leave open on a hand, as the strategy is asked about it
+typedef struct
 {
-    bool debug = false; // Set to true to debug first hand
-    for (int i = 0; i < simulation_config->num_hands; i++)
+    bool split_aces;  // Split aces that may not be hit
+    bool can_split;
+    bool can_double;
+    bool can_surrender;
+} OpenPlays;
+
+static OpenPlays open_plays(GameState *game, Rules *rules, Hand *hand)
+{
+    OpenPlays plays;
+    // Hands are only ever added by splitting, so with more than one every hand came from a split
+    bool split_hand = game->num_player_hands > 1;
+    bool pair_of_aces = hand->num_cards == 2 && card_rank(hand->cards[0]) == 0 && card_rank(hand->cards[1]) == 0;
+    plays.split_aces = split_hand && card_rank(hand->cards[0]) == 0 && !rules->can_hit_split_aces;
+    plays.can_split = can_split(rules, game->num_player_hands, split_hand && pair_of_aces);
+    plays.can_double = !plays.split_aces && can_double(rules, split_hand ? SPLIT : HIT, hand->num_cards);
+    plays.can_surrender = !split_hand && hand->num_cards == 2;
+    return plays;
+}
+
+// The next play on an open hand, by config's rules and strategy. Split aces
+// that may not be hit come back as STAND unless they can be resplit.
+PlayerAction simulation_choose_action(GameState *game, SimulationConfig *simulation_config, int player_hand_index)
+{
+    Rules *rules = &simulation_config->rules;
+    Hand *hand = &game->player_hands[player_hand_index];
+    OpenPlays plays = open_plays(game, rules, hand);
+    PlayerAction action = get_basic_strategy_action(hand,
+                                                    game->dealer_hand.cards[0], rules, &simulation_config->strategy,
+                                                    plays.can_split, plays.can_double, plays.can_surrender);
+
+    // Split aces get one card each; the only play left is a resplit where allowed
+    if (plays.split_aces && action != SPLIT)
     {
-        debug = false; // Disabled
-        GameState game;
-        game_init(&game, &simulation_config->rules, simulation_config->bet_per_hand);
-        game_deal_initial(&game);
-        if (debug) {
-            printf("\n=== Hand %d ===\n", i);
-            printf("Player: %d, Dealer up: %d\n",
-                   hand_get_value(&game.player_hands[0]),
-                   card_value(game.dealer_hand.cards[0]));
-        }
+        return STAND;
+    }
+    return action;
+}
 
-        // Check for dealer blackjack (if peek rules enabled)
-        bool dealer_has_blackjack = false;
-        if (game.rules.dealer_peeks_blackjack && hand_is_blackjack(&game.dealer_hand)) {
-            dealer_has_blackjack = true;
-            if (debug) printf("Dealer has blackjack! Round ends immediately.\n");
-        }
+// Whether action is a legal play on an open hand, by config's rules
+bool simulation_action_allowed(GameState *game, SimulationConfig *simulation_config, int player_hand_index, PlayerAction action)
+{
+    Rules *rules = &simulation_config->rules;
+    Hand *hand = &game->player_hands[player_hand_index];
+    OpenPlays plays = open_plays(game, rules, hand);
+    bool splittable = plays.can_split && rules->max_splits > 0 && hand_can_split(hand);
 
-        // Player plays all hands (only if dealer doesn't have blackjack)
-        int player_hand_index = 0;
-        while (player_hand_index < game.num_player_hands && !dealer_has_blackjack)
+    switch (action)
+    {
+    case HIT:
+        return !plays.split_aces && hand_get_value(hand) < 21;
+    case STAND:
+        return true;
+    case DOUBLE:
+        return plays.can_double && hand->num_cards == 2;
+    case SPLIT:
+        return splittable;
+    case SURRENDER:
+        return plays.can_surrender && rules->late_surrender_allowed;
+    default:
+        return false;
+    }
+}
+
+void simulation_play_player_hands(GameState *game, SimulationConfig *simulation_config, SimulationResults *simulation_results)
+{
+    simulation_play_player_hands_from(game, simulation_config, simulation_results, 0);
+}
+
+// Plays every hand from first_hand on; first_hand must still be waiting for its next play.
+// simulation_results may be NULL when the doubles and splits taken aren't wanted.
+void simulation_play_player_hands_from(GameState *game, SimulationConfig *simulation_config, SimulationResults *simulation_results, int first_hand)
+{
+    for (int player_hand_index = first_hand; player_hand_index < game->num_player_hands; player_hand_index++)
+    {
+        Hand *hand = &game->player_hands[player_hand_index];
+        PlayerAction curr_player_action;
+        do
         {
-            PlayerAction curr_player_action = HIT;
-            bool player_bust = false;
-            bool split_aces = false;
-            while ((curr_player_action == HIT || curr_player_action == SPLIT) && !player_bust && !split_aces)
+            curr_player_action = simulation_choose_action(game, simulation_config, player_hand_index);
+
+            // Track doubles and splits
+            if (simulation_results != NULL && curr_player_action == DOUBLE)
             {
-                curr_player_action = get_basic_strategy_action(&game.player_hands[player_hand_index],
-                                                               game.dealer_hand.cards[0], &simulation_config->rules, &simulation_config->strategy,
-                                                               can_split(&game.rules, game.num_player_hands, split_aces),
-                                                               can_double(&game.rules, curr_player_action, game.player_hands[player_hand_index].num_cards),
-                                                               game.num_player_hands == 1 && game.player_hands[player_hand_index].num_cards == 2);
-
-                if (debug) {
-                    const char* actions[] = {"HIT", "STAND", "DOUBLE", "SPLIT", "SURRENDER"};
-                    printf("Hand %d (value=%d, soft=%d): Action = %s\n",
-                           player_hand_index,
-                           hand_get_value(&game.player_hands[player_hand_index]),
-                           hand_is_soft(&game.player_hands[player_hand_index]),
-                           actions[curr_player_action]);
-                }
+                simulation_results->doubles_taken++;
+            }
+            else if (simulation_results != NULL && curr_player_action == SPLIT)
+            {
+                simulation_results->splits_taken++;
+            }
 
-                split_aces = false;
-                // Track doubles and splits
-                if (curr_player_action == DOUBLE)
-                {
-                    simulation_results->doubles_taken++;
-                }
-                else if (curr_player_action == SPLIT)
-                {
-                    if (card_rank(game.player_hands[player_hand_index].cards[0]) == 0 && card_rank(game.player_hands[player_hand_index].cards[1]) == 0)
-                    {
-                        split_aces = true;
-                    }
-                    simulation_results->splits_taken++;
-                }
+            game_play_action(game, curr_player_action, player_hand_index);
+        } while ((curr_player_action == HIT || curr_player_action == SPLIT) && hand_get_value(hand) <= 21);
+    }
+}
+
+bool simulation_all_hands_busted(GameState *game)
+{
+    for (int i = 0; i < game->num_player_hands; i++)
+    {
+        if (hand_get_value(&game->player_hands[i]) <= 21)
+        {
+            return false;
+        }
+    }
 
-                game_play_action(&game, curr_player_action, player_hand_index);
+    return true;
+}
 
-                int hand_value = hand_get_value(&game.player_hands[player_hand_index]);
-                if (debug) printf("After action, player hand %d value: %d\n", player_hand_index, hand_value);
-                if (hand_value > 21)
-                {
-                    player_bust = true;
-                    if (debug) printf("Player hand %d BUSTED\n", player_hand_index);
-                }
-            }
+void simulation_play_dealer(GameState *game)
+{
+    dealer_play(&game->dealer_table, &game->dealer_hand, game->shoe);
+}
 
-            player_hand_index++;
+// Every card dealt this round is face up by the time the round is resolved,
+// so the counter catches up on the whole round in one pass.
+static void observe_round(CountTracker *tracker, GameState *game)
+{
+    for (int i = 0; i < game->num_player_hands; i++)
+    {
+        for (int j = 0; j < game->player_hands[i].num_cards; j++)
+        {
+            count_tracker_observe(tracker, game->player_hands[i].cards[j]);
         }
+    }
 
-        // Dealer plays once after all player hands are complete
-        // Only play if dealer doesn't have blackjack and at least one player hand didn't bust
-        bool all_hands_busted = true;
-        for (int i = 0; i < game.num_player_hands; i++) {
-            if (hand_get_value(&game.player_hands[i]) <= 21) {
-                all_hands_busted = false;
-                break;
-            }
+    for (int j = 0; j < game->dealer_hand.num_cards; j++)
+    {
+        count_tracker_observe(tracker, game->dealer_hand.cards[j]);
+    }
+}
+
+// Deal one card to a fast-forwarded hand, tracking only its total and how
+// many aces still count as 11
+static void fast_forward_draw(GameState *game, CountTracker *tracker, int *total, int *soft_aces)
+{
+    int card = deck_deal(&game->deck);
+    count_tracker_observe(tracker, card);
+
+    int value = card_value(card);
+    *total += value;
+    if (value == 11)
+    {
+        (*soft_aces)++;
+    }
+    if (*total > 21 && *soft_aces > 0)
+    {
+        *total -= 10;
+        (*soft_aces)--;
+    }
+}
+
+// Close enough to basic strategy to use up a realistic number of cards per round
+static bool fast_forward_should_hit(int total, bool soft, int upcard_value)
+{
+    if (soft)
+    {
+        return total <= 17;
+    }
+    if (total <= 11)
+    {
+        return true;
+    }
+    if (total >= 17)
+    {
+        return false;
+    }
+    if (upcard_value >= 7)
+    {
+        return true;
+    }
+
+    return total == 12 && upcard_value <= 3;
+}
+
+// A round the back-counter sits out. The shoe still gives up the cards a
+// seat and the dealer would take, and the count sees every one of them, but
+// there are no Hand structs, strategy lookups or game_resolve().
+static void fast_forward_round(GameState *game, CountTracker *tracker)
+{
+    int player_total = 0;
+    int player_soft_aces = 0;
+    int dealer_total = 0;
+    int dealer_soft_aces = 0;
+
+    fast_forward_draw(game, tracker, &player_total, &player_soft_aces);
+    fast_forward_draw(game, tracker, &dealer_total, &dealer_soft_aces);
+    int upcard_value = dealer_total;
+    fast_forward_draw(game, tracker, &player_total, &player_soft_aces);
+    fast_forward_draw(game, tracker, &dealer_total, &dealer_soft_aces);
+
+    if (dealer_total == 21 && game->rules.dealer_peeks_blackjack)
+    {
+        return;
+    }
+    if (player_total == 21)
+    {
+        return;
+    }
+
+    while (fast_forward_should_hit(player_total, player_soft_aces > 0, upcard_value))
+    {
+        fast_forward_draw(game, tracker, &player_total, &player_soft_aces);
+    }
+    if (player_total > 21)
+    {
+        return;
+    }
+
+    while (dealer_total < 17 || (dealer_total == 17 && dealer_soft_aces > 0 && game->rules.dealer_hits_soft_17))
+    {
+        fast_forward_draw(game, tracker, &dealer_total, &dealer_soft_aces);
+    }
+}
+
+void simulation_record_round(SimulationResults *simulation_results, GameState *game, double initial_bet, const int *count_buckets, int num_count_systems)
+{
+    double round_payout = game_resolve(game);
+    double round_bets = 0.0;
+    for (int j = 0; j < game->num_player_hands; j++)
+    {
+        round_bets += game->player_bets[j];
+    }
+
+    simulation_record_payout(simulation_results, round_bets, round_payout, initial_bet, count_buckets, num_count_systems);
+    simulation_record_outcomes(simulation_results, game, initial_bet, round_bets, round_payout);
+}
+
+// File a resolved round's hands under their payout categories
+void simulation_record_outcomes(SimulationResults *simulation_results, GameState *game, double initial_bet, double round_bets, double round_payout)
+{
+    PayoutTable *payouts = &simulation_results->payouts;
+    bool split = game->num_player_hands > 1;
+    bool natural = false;
+    for (int j = 0; j < game->num_player_hands; j++)
+    {
+        HandOutcome outcome = game_hand_outcome(game, j);
+        natural |= outcome == HAND_NATURAL;
+        payout_table_record_hand(payouts, outcome, game->player_bets[j] > initial_bet, split);
+    }
+
+    bool dealer_ace = card_rank(game->dealer_hand.cards[0]) == 0;
+    payout_table_record_round(payouts, (round_payout - round_bets) / initial_bet, natural, dealer_ace,
+                              hand_is_blackjack(&game->dealer_hand));
+}
+
+// Book one resolved round: everything staked and everything paid back
+void simulation_record_payout(SimulationResults *simulation_results, double round_bets, double round_payout, double initial_bet, const int *count_buckets, int num_count_systems)
+{
+    if (round_payout == 0 || round_payout < round_bets)
+    {
+        simulation_results->hands_lost++;
+    }
+    else if (round_payout > round_bets)
+    {
+        simulation_results->hands_won++;
+    }
+    else if (round_payout == round_bets)
+    {
+        simulation_results->hands_pushed++;
+    }
+    simulation_results->total_bet += round_bets;
+    simulation_results->total_payout += round_payout;
+    simulation_results->hands_played++;
+    simulation_results->house_edge = (simulation_results->total_bet - simulation_results->total_payout) / simulation_results->total_bet;
+
+    double round_result = (round_payout - round_bets) / initial_bet;
+    simulation_results->total_result += round_result;
+    simulation_results->total_result_squared += round_result * round_result;
+    for (int s = 0; s < num_count_systems; s++)
+    {
+        count_table_record(&simulation_results->count_tables[s], count_buckets[s], round_result);
+    }
+}
+
+void simulation_context_init(SimulationContext *context)
+{
+    context->num_games = 0;
+}
+
+// Readies the first num_games games for a run of simulation_config. Games
+// already built keep their allocations unless the deck count or split limit
+// changed; only the rules and dealer table are refreshed.
+void simulation_context_prepare(SimulationContext *context, SimulationConfig *simulation_config, int num_games)
+{
+    Rules *rules = &simulation_config->rules;
+    for (int g = 0; g < num_games; g++)
+    {
+        GameState *game = &context->games[g];
+        if (g >= context->num_games)
+        {
+            game_init(game, rules, simulation_config->bet_per_hand);
+            context->num_games++;
+        }
+        else if (game->deck.num_decks != rules->num_decks || game->rules.max_splits != rules->max_splits)
+        {
+            game_destroy(game);
+            game_init(game, rules, simulation_config->bet_per_hand);
         }
+        else
+        {
+            game->rules = *rules;
+            dealer_table_init(&game->dealer_table, rules);
+        }
+        deck_set_mode(&game->deck, simulation_config->deck_mode == DECK_SHUFFLE_FULL ? DECK_SHUFFLE_LAZY : simulation_config->deck_mode);
+    }
+}
 
-        if (!dealer_has_blackjack && !all_hands_busted) {
-            PlayerAction curr_dealer_action = HIT;
-            if (debug) printf("Dealer playing...\n");
-            while (curr_dealer_action != STAND)
+void simulation_context_destroy(SimulationContext *context)
+{
+    for (int g = 0; g < context->num_games; g++)
+    {
+        game_destroy(&context->games[g]);
+    }
+    context->num_games = 0;
+}
+
+void simulation_run(SimulationConfig *simulation_config, SimulationResults *simulation_results)
+{
+    SimulationContext context;
+    simulation_context_init(&context);
+    simulation_run_in(&context, simulation_config, simulation_results);
+    simulation_context_destroy(&context);
+}
+
+void simulation_run_in(SimulationContext *context, SimulationConfig *simulation_config, SimulationResults *simulation_results)
+{
+    bool counting = simulation_config->count_systems != NULL && simulation_config->num_count_systems > 0;
+    simulation_context_prepare(context, simulation_config, 1);
+    GameState *game = &context->games[0];
+    if (simulation_config->seed != 0)
+    {
+        // Uncounted rounds shuffle before every deal, so round k is shoe first_shoe + k
+        deck_seed(&game->deck, simulation_config->seed, simulation_config->first_shoe);
+    }
+    if (counting)
+    {
+        // Counting starts from a full shoe, not wherever the last run left it
+        deck_shuffle(&game->deck);
+    }
+
+    CountTracker tracker;
+    if (counting)
+    {
+        count_tracker_init(&tracker, simulation_config->count_systems, simulation_config->num_count_systems, simulation_config->rules.num_decks);
+    }
+    int reshuffle_at = (int)(simulation_config->rules.shoe_penetration * game->deck.total_cards);
+    bool wonging = counting && simulation_config->wonging;
+    bool seated = false;
+
+    for (int i = 0; i < simulation_config->num_hands; i++)
+    {
+        double initial_bet = simulation_config->bet_per_hand;
+        int count_buckets[COUNT_MAX_SYSTEMS];
+
+        if (!counting)
+        {
+            // Nothing carries over between rounds without a count, so every
+            // round is dealt from a freshly shuffled shoe.
+            deck_shuffle(&game->deck);
+        }
+        else
+        {
+            if (game->deck.position >= reshuffle_at)
             {
-                int hand_value = hand_get_value(&game.dealer_hand);
-                if (debug) printf("Dealer hand value: %d\n", hand_value);
-                if (hand_value == 17 && hand_is_soft(&game.dealer_hand) && game.rules.dealer_hits_soft_17)
-                {
-                    curr_dealer_action = HIT;
-                }
-                else if (hand_value >= 17)
+                deck_shuffle(&game->deck);
+                count_tracker_reset(&tracker);
+                seated = false;
+            }
+
+            if (wonging)
+            {
+                double count = count_tracker_index(&tracker, 0);
+                if (seated && count < simulation_config->wong_out)
                 {
-                    curr_dealer_action = STAND;
+                    seated = false;
                 }
-                else
+                else if (!seated && count >= simulation_config->wong_in)
                 {
-                    curr_dealer_action = HIT;
+                    seated = true;
                 }
 
-                if (curr_dealer_action == HIT)
+                if (!seated)
                 {
-                    hand_add_card(&game.dealer_hand, deck_deal(&game.deck));
+                    int round_start_position = game->deck.position;
+                    fast_forward_round(game, &tracker);
+                    if (game->deck.position < round_start_position)
+                    {
+                        count_tracker_reset(&tracker);
+                    }
+                    simulation_results->rounds_sat_out++;
+                    continue;
                 }
             }
-        }
 
-        double round_payout = game_resolve(&game);
-        double round_bets = 0.0;
-        for (int i = 0; i < game.num_player_hands; i++) {
-            round_bets += game.player_bets[i];
-        }
-        if (debug) {
-            printf("Final: Dealer=%d, Player hands=%d\n",
-                   hand_get_value(&game.dealer_hand), game.num_player_hands);
-            for (int i = 0; i < game.num_player_hands; i++) {
-                printf("  Hand %d: value=%d, bet=%.2f\n",
-                       i, hand_get_value(&game.player_hands[i]), game.player_bets[i]);
+            count_tracker_buckets(&tracker, count_buckets);
+            if (simulation_config->bet_ramp != NULL)
+            {
+                initial_bet *= simulation_config->bet_ramp->units[count_buckets[0]];
             }
-            printf("Round bets: %.2f, Round payout: %.2f\n", round_bets, round_payout);
-            debug = false;
         }
-        if (round_payout == 0 || round_payout < round_bets)
+
+        game_reset_round(game, initial_bet);
+        int round_start_position = game->deck.position;
+        game_deal_initial(game);
+
+        // Check for dealer blackjack (if peek rules enabled)
+        bool dealer_has_blackjack = game->rules.dealer_peeks_blackjack && hand_is_blackjack(&game->dealer_hand);
+
+        // Player plays all hands (only if dealer doesn't have blackjack)
+        if (!dealer_has_blackjack)
         {
-            simulation_results->hands_lost++;
-        } else if (round_payout > round_bets)
+            simulation_play_player_hands(game, simulation_config, simulation_results);
+        }
+
+        // Dealer plays once after all player hands are complete
+        // Only play if dealer doesn't have blackjack and at least one player hand didn't bust
+        if (!dealer_has_blackjack && !simulation_all_hands_busted(game))
         {
-            simulation_results->hands_won++;
+            simulation_play_dealer(game);
         }
-        else if (round_payout == round_bets)
+
+        simulation_record_round(simulation_results, game, initial_bet,
+                                counting ? count_buckets : NULL, counting ? tracker.num_systems : 0);
+
+        if (counting)
         {
-            simulation_results->hands_pushed++;
+            if (game->deck.position < round_start_position)
+            {
+                // The shoe ran out mid-round and was reshuffled; start counting again
+                count_tracker_reset(&tracker);
+            }
+            else
+            {
+                observe_round(&tracker, game);
+            }
         }
-        simulation_results->total_bet += round_bets;
-        simulation_results->total_payout += round_payout;
-        simulation_results->hands_played++;
-        simulation_results->house_edge = (simulation_results->total_bet - simulation_results->total_payout) / simulation_results->total_bet;
-        game_destroy(&game);
     }
+
+}
+
+// Adds one run's results into a running total, e.g. the chunks of a job run in pieces
+void simulation_results_add(SimulationResults* total, const SimulationResults* simulation_results, int num_count_systems)
+{
+    total->hands_played += simulation_results->hands_played;
+    total->hands_won += simulation_results->hands_won;
+    total->hands_lost += simulation_results->hands_lost;
+    total->hands_pushed += simulation_results->hands_pushed;
+    total->doubles_taken += simulation_results->doubles_taken;
+    total->splits_taken += simulation_results->splits_taken;
+    total->total_bet += simulation_results->total_bet;
+    total->total_payout += simulation_results->total_payout;
+    total->total_result += simulation_results->total_result;
+    total->total_result_squared += simulation_results->total_result_squared;
+    total->rounds_sat_out += simulation_results->rounds_sat_out;
+    if (total->total_bet > 0)
+    {
+        total->house_edge = (total->total_bet - total->total_payout) / total->total_bet;
+    }
+
+    for (int s = 0; s < num_count_systems; s++)
+    {
+        count_table_add(&total->count_tables[s], &simulation_results->count_tables[s]);
+    }
+    payout_table_add(&total->payouts, &simulation_results->payouts);
 }
 
 double simulation_get_ev(SimulationResults* simulation_results)
 {
     return -simulation_results->house_edge;
-}
\ No newline at end of file
+}
+
+// Per round, in units of the initial bet: what rule comparisons quote as the edge
+double simulation_get_ev_per_round(SimulationResults* simulation_results)
+{
+    if (simulation_results->hands_played == 0)
+    {
+        return 0.0;
+    }
+    return simulation_results->total_result / simulation_results->hands_played;
+}
+
+double simulation_get_ev_standard_error(SimulationResults* simulation_results)
+{
+    int rounds = simulation_results->hands_played;
+    if (rounds < 2)
+    {
+        return 0.0;
+    }
+    double mean = simulation_results->total_result / rounds;
+    double variance = (simulation_results->total_result_squared / rounds - mean * mean) * rounds / (rounds - 1);
+    return sqrt(variance > 0 ? variance / rounds : 0.0);
+}
+
+void simulation_print_count_report(FILE *out, SimulationConfig *simulation_config, SimulationResults *simulation_results, const BetRampSolverConfig *spread)
+{
+    for (int s = 0; s < simulation_config->num_count_systems; s++)
+    {
+        const CountTable *table = &simulation_results->count_tables[s];
+        BetRamp ramp;
+        BetRampStats stats;
+        bet_ramp_solve(table, spread, &ramp);
+        bet_ramp_evaluate(&ramp, table, spread->bankroll, &stats);
+
+        fprintf(out, "%s: SCORE %.2f, win %.4f units/round, SD %.3f, N0 %.0f (spread %g-%g)\n",
+                simulation_config->count_systems[s].name, stats.score, stats.win_rate,
+                stats.std_dev, stats.n0, spread->min_bet, spread->max_bet);
+        fprintf(out, "   %s     freq       EV       SD    bet\n",
+                count_system_is_balanced(&simulation_config->count_systems[s]) ? "TC" : "RC");
+
+        for (int b = 0; b < COUNT_NUM_BUCKETS; b++)
+        {
+            const CountBucket *bucket = &table->buckets[b];
+            if (bucket->rounds == 0)
+            {
+                continue;
+            }
+
+            fprintf(out, "  %+3d  %6.2f%%  %+6.2f%%  %6.3f  %5.1f\n",
+                    count_bucket_true_count(b),
+                    100.0 * bucket->rounds / simulation_results->hands_played,
+                    100.0 * count_bucket_ev(bucket),
+                    sqrt(count_bucket_variance(bucket)),
+                    ramp.units[b]);
+        }
+    }
+}
+
+void simulation_verify_bet_ramp(SimulationConfig *simulation_config, const BetRamp *ramp, const CountTable *recorded, double bankroll, BetRampVerification *verification)
+{
+    SimulationConfig verify_config = *simulation_config;
+    verify_config.bet_ramp = ramp;
+
+    SimulationResults results = {0};
+    simulation_run(&verify_config, &results);
+
+    bet_ramp_evaluate(ramp, recorded, bankroll, &verification->predicted);
+    bet_ramp_evaluate(ramp, &results.count_tables[0], bankroll, &verification->observed);
+    verification->observed_rounds = results.hands_played;
+
+    long recorded_rounds = 0;
+    for (int i = 0; i < COUNT_NUM_BUCKETS; i++)
+    {
+        recorded_rounds += recorded->buckets[i].rounds;
+    }
+
+    double predicted_sd = verification->predicted.std_dev;
+    double observed_sd = verification->observed.std_dev;
+    verification->win_rate_std_error = sqrt(
+        (recorded_rounds > 0 ? predicted_sd * predicted_sd / recorded_rounds : 0.0) +
+        (results.hands_played > 0 ? observed_sd * observed_sd / results.hands_played : 0.0));
+}
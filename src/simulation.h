@@ -1,11 +1,27 @@
+#pragma once
+
+#include <stdio.h>
 #include "rules.h"
 #include "strategy.h"
+#include "game.h"
+#include "counting.h"
+#include "betting.h"
+#include "payout.h"
 
 typedef struct {
     int num_hands;
     Rules rules;
     BasicStrategy strategy;
     double bet_per_hand;
+    const CountSystem* count_systems;  // NULL = no counting, every round is dealt from a fresh shoe
+    int num_count_systems;             // Up to COUNT_MAX_SYSTEMS, all tracked from the same shoes
+    const BetRamp* bet_ramp;           // NULL = flat bet_per_hand; keyed on count_systems[0]
+    bool wonging;                      // Back-count: only play between wong_in and wong_out
+    double wong_in;                    // Sit down once count_systems[0]'s count (count_tracker_index) reaches this
+    double wong_out;                   // Get up once it drops below this; sit out after every shuffle
+    DeckMode deck_mode;                // DECK_COMPOSITION or DECK_INFINITE; either shuffle mode deals lazily
+    uint64_t seed;                     // Nonzero: the k-th shoe is (seed, first_shoe + k), see deck_replay
+    uint64_t first_shoe;               // 0 seed = next shoes from the thread's default (deck_set_rng_seed)
 } SimulationConfig;
 
 typedef struct {
@@ -17,9 +33,61 @@ typedef struct {
     int splits_taken;
     double total_bet;
     double total_payout;
+    double total_result;          // Sum of round results, in units of the initial bet
+    double total_result_squared;  // Sum of squared round results
     double house_edge;
+    int rounds_sat_out;                          // Wonging: rounds dealt without us; num_hands counts both
+    CountTable count_tables[COUNT_MAX_SYSTEMS];  // One per count system, filled only when counting
+    PayoutTable payouts;                         // Every played round by outcome, for payout_score()
 } SimulationResults;
 
+#define SIMULATION_CONTEXT_GAMES 8  // One per vector lane, see LANES_WIDTH
+
+// Per-thread state kept from one run to the next: games with their own
+// shoes, hands and dealer tables, rebuilt only when the deck count or split
+// limit changes. The scalar engine plays games[0]; the lane engine deals one
+// round from each. Unseeded runs keep drawing from the games' shoe streams.
+typedef struct {
+    GameState games[SIMULATION_CONTEXT_GAMES];
+    int num_games;  // Initialized so far
+} SimulationContext;
+
+void simulation_context_init(SimulationContext* context);
+
+void simulation_context_prepare(SimulationContext* context, SimulationConfig* simulation_config, int num_games);
+
+void simulation_context_destroy(SimulationContext* context);
+
 void simulation_run(SimulationConfig* simulation_config_init, SimulationResults* simulation_results);
 
-double simulation_get_ev(SimulationResults* simulation_result);
\ No newline at end of file
+void simulation_run_in(SimulationContext* context, SimulationConfig* simulation_config, SimulationResults* simulation_results);
+
+PlayerAction simulation_choose_action(GameState* game, SimulationConfig* simulation_config, int player_hand_index);
+
+bool simulation_action_allowed(GameState* game, SimulationConfig* simulation_config, int player_hand_index, PlayerAction action);
+
+void simulation_play_player_hands(GameState* game, SimulationConfig* simulation_config, SimulationResults* simulation_results);
+
+void simulation_play_player_hands_from(GameState* game, SimulationConfig* simulation_config, SimulationResults* simulation_results, int first_hand);
+
+bool simulation_all_hands_busted(GameState* game);
+
+void simulation_play_dealer(GameState* game);
+
+void simulation_record_round(SimulationResults* simulation_results, GameState* game, double initial_bet, const int* count_buckets, int num_count_systems);
+
+void simulation_record_outcomes(SimulationResults* simulation_results, GameState* game, double initial_bet, double round_bets, double round_payout);
+
+void simulation_record_payout(SimulationResults* simulation_results, double round_bets, double round_payout, double initial_bet, const int* count_buckets, int num_count_systems);
+
+void simulation_results_add(SimulationResults* total, const SimulationResults* simulation_results, int num_count_systems);
+
+double simulation_get_ev(SimulationResults* simulation_result);
+
+double simulation_get_ev_per_round(SimulationResults* simulation_results);
+
+double simulation_get_ev_standard_error(SimulationResults* simulation_results);
+
+void simulation_print_count_report(FILE* out, SimulationConfig* simulation_config, SimulationResults* simulation_results, const BetRampSolverConfig* spread);
+
+void simulation_verify_bet_ramp(SimulationConfig* simulation_config, const BetRamp* ramp, const CountTable* recorded, double bankroll, BetRampVerification* verification);
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "strategy.h"
 #include "card.h"
+#include <string.h>
 
 // Helper macros for readability
 #define DEALER_IDX(card_value) ((card_value) - 2)  // Maps dealer 2-11 to indices 0-9
@@ -23,297 +24,71 @@
 #define SUR_IDX_15  1
 #define SUR_IDX_16  2
 
-void basic_strategy_init(BasicStrategy* strategy) {
-    // =======================================================================
-    // HARD TOTALS (player 8-16 vs dealer 2-11)
-    // =======================================================================
-    // Reading from the chart bottom to top (8, 9, 10, 11, 12, 13, 14, 15, 16)
-
-    // Dealer: 2, 3, 4, 5, 6, 7, 8, 9, 10, A
-    // Player 8: H, H, H, H, H, H, H, H, H, H
-    for (int d = 0; d < 10; d++) {
-        strategy->hard_totals[d][HARD_IDX(8)] = HIT;
-    }
-
-    // Player 9: H, D, D, D, D, H, H, H, H, H
-    strategy->hard_totals[DEALER_IDX(2)][HARD_IDX(9)] = HIT;
-    strategy->hard_totals[DEALER_IDX(3)][HARD_IDX(9)] = DOUBLE;
-    strategy->hard_totals[DEALER_IDX(4)][HARD_IDX(9)] = DOUBLE;
-    strategy->hard_totals[DEALER_IDX(5)][HARD_IDX(9)] = DOUBLE;
-    strategy->hard_totals[DEALER_IDX(6)][HARD_IDX(9)] = DOUBLE;
-    strategy->hard_totals[DEALER_IDX(7)][HARD_IDX(9)] = HIT;
-    strategy->hard_totals[DEALER_IDX(8)][HARD_IDX(9)] = HIT;
-    strategy->hard_totals[DEALER_IDX(9)][HARD_IDX(9)] = HIT;
-    strategy->hard_totals[DEALER_IDX(10)][HARD_IDX(9)] = HIT;
-    strategy->hard_totals[DEALER_IDX(11)][HARD_IDX(9)] = HIT;
-
-    // Player 10: D, D, D, D, D, D, D, D, H, H
-    for (int d = 0; d < 8; d++) {
-        strategy->hard_totals[d][HARD_IDX(10)] = DOUBLE;
-    }
-    strategy->hard_totals[DEALER_IDX(10)][HARD_IDX(10)] = HIT;
-    strategy->hard_totals[DEALER_IDX(11)][HARD_IDX(10)] = HIT;
-
-    // Player 11: D, D, D, D, D, D, D, D, D, D
-    for (int d = 0; d < 10; d++) {
-        strategy->hard_totals[d][HARD_IDX(11)] = DOUBLE;
-    }
-
-    // Player 12: H, H, S, S, S, H, H, H, H, H
-    strategy->hard_totals[DEALER_IDX(2)][HARD_IDX(12)] = HIT;
-    strategy->hard_totals[DEALER_IDX(3)][HARD_IDX(12)] = HIT;
-    strategy->hard_totals[DEALER_IDX(4)][HARD_IDX(12)] = STAND;
-    strategy->hard_totals[DEALER_IDX(5)][HARD_IDX(12)] = STAND;
-    strategy->hard_totals[DEALER_IDX(6)][HARD_IDX(12)] = STAND;
-    strategy->hard_totals[DEALER_IDX(7)][HARD_IDX(12)] = HIT;
-    strategy->hard_totals[DEALER_IDX(8)][HARD_IDX(12)] = HIT;
-    strategy->hard_totals[DEALER_IDX(9)][HARD_IDX(12)] = HIT;
-    strategy->hard_totals[DEALER_IDX(10)][HARD_IDX(12)] = HIT;
-    strategy->hard_totals[DEALER_IDX(11)][HARD_IDX(12)] = HIT;
-
-    // Player 13: S, S, S, S, S, H, H, H, H, H
-    for (int d = 0; d < 5; d++) {
-        strategy->hard_totals[d][HARD_IDX(13)] = STAND;
-    }
-    for (int d = 5; d < 10; d++) {
-        strategy->hard_totals[d][HARD_IDX(13)] = HIT;
-    }
-
-    // Player 14: S, S, S, S, S, H, H, H, H, H (same as 13)
-    for (int d = 0; d < 5; d++) {
-        strategy->hard_totals[d][HARD_IDX(14)] = STAND;
-    }
-    for (int d = 5; d < 10; d++) {
-        strategy->hard_totals[d][HARD_IDX(14)] = HIT;
-    }
-
-    // Player 15: S, S, S, S, S, H, H, H, H, H (same as 13, 14)
-    for (int d = 0; d < 5; d++) {
-        strategy->hard_totals[d][HARD_IDX(15)] = STAND;
-    }
-    for (int d = 5; d < 10; d++) {
-        strategy->hard_totals[d][HARD_IDX(15)] = HIT;
-    }
-
-    // Player 16: S, S, S, S, S, H, H, H, H, H (same as 13-15)
-    for (int d = 0; d < 5; d++) {
-        strategy->hard_totals[d][HARD_IDX(16)] = STAND;
-    }
-    for (int d = 5; d < 10; d++) {
-        strategy->hard_totals[d][HARD_IDX(16)] = HIT;
-    }
-
-    // =======================================================================
-    // SOFT TOTALS (A-2 through A-9 vs dealer 2-11)
-    // =======================================================================
-    // Reading from chart bottom to top: A-2(13), A-3(14), A-4(15), A-5(16), A-6(17), A-7(18), A-8(19), A-9(20)
-
-    // A-2 (13): H, H, H, D, D, H, H, H, H, H
-    strategy->soft_totals[DEALER_IDX(2)][SOFT_IDX(13)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(3)][SOFT_IDX(13)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(4)][SOFT_IDX(13)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(5)][SOFT_IDX(13)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(6)][SOFT_IDX(13)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(7)][SOFT_IDX(13)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(8)][SOFT_IDX(13)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(9)][SOFT_IDX(13)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(10)][SOFT_IDX(13)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(11)][SOFT_IDX(13)] = SOFT_HIT;
-
-    // A-3 (14): H, H, H, D, D, H, H, H, H, H (same as A-2)
-    strategy->soft_totals[DEALER_IDX(2)][SOFT_IDX(14)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(3)][SOFT_IDX(14)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(4)][SOFT_IDX(14)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(5)][SOFT_IDX(14)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(6)][SOFT_IDX(14)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(7)][SOFT_IDX(14)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(8)][SOFT_IDX(14)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(9)][SOFT_IDX(14)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(10)][SOFT_IDX(14)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(11)][SOFT_IDX(14)] = SOFT_HIT;
-
-    // A-4 (15): H, H, D, D, D, H, H, H, H, H
-    strategy->soft_totals[DEALER_IDX(2)][SOFT_IDX(15)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(3)][SOFT_IDX(15)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(4)][SOFT_IDX(15)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(5)][SOFT_IDX(15)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(6)][SOFT_IDX(15)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(7)][SOFT_IDX(15)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(8)][SOFT_IDX(15)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(9)][SOFT_IDX(15)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(10)][SOFT_IDX(15)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(11)][SOFT_IDX(15)] = SOFT_HIT;
+// Built from charts/*.chart; see tools/chartc.c
+typedef struct {
+    const char* name;
+    BasicStrategy strategy;
+} StrategyChart;
 
-    // A-5 (16): H, H, D, D, D, H, H, H, H, H (same as A-4)
-    strategy->soft_totals[DEALER_IDX(2)][SOFT_IDX(16)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(3)][SOFT_IDX(16)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(4)][SOFT_IDX(16)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(5)][SOFT_IDX(16)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(6)][SOFT_IDX(16)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(7)][SOFT_IDX(16)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(8)][SOFT_IDX(16)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(9)][SOFT_IDX(16)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(10)][SOFT_IDX(16)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(11)][SOFT_IDX(16)] = SOFT_HIT;
+#include "strategy_charts.h"
 
-    // A-6 (17): H, D, D, D, D, H, H, H, H, H
-    strategy->soft_totals[DEALER_IDX(2)][SOFT_IDX(17)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(3)][SOFT_IDX(17)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(4)][SOFT_IDX(17)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(5)][SOFT_IDX(17)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(6)][SOFT_IDX(17)] = SOFT_DOUBLE_OR_HIT;
-    strategy->soft_totals[DEALER_IDX(7)][SOFT_IDX(17)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(8)][SOFT_IDX(17)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(9)][SOFT_IDX(17)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(10)][SOFT_IDX(17)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(11)][SOFT_IDX(17)] = SOFT_HIT;
-
-    // A-7 (18): Ds, Ds, Ds, Ds, Ds, S, S, H, H, H
-    strategy->soft_totals[DEALER_IDX(2)][SOFT_IDX(18)] = SOFT_DOUBLE_OR_STAND;
-    strategy->soft_totals[DEALER_IDX(3)][SOFT_IDX(18)] = SOFT_DOUBLE_OR_STAND;
-    strategy->soft_totals[DEALER_IDX(4)][SOFT_IDX(18)] = SOFT_DOUBLE_OR_STAND;
-    strategy->soft_totals[DEALER_IDX(5)][SOFT_IDX(18)] = SOFT_DOUBLE_OR_STAND;
-    strategy->soft_totals[DEALER_IDX(6)][SOFT_IDX(18)] = SOFT_DOUBLE_OR_STAND;
-    strategy->soft_totals[DEALER_IDX(7)][SOFT_IDX(18)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(8)][SOFT_IDX(18)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(9)][SOFT_IDX(18)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(10)][SOFT_IDX(18)] = SOFT_HIT;
-    strategy->soft_totals[DEALER_IDX(11)][SOFT_IDX(18)] = SOFT_HIT;
-
-    // A-8 (19): S, S, S, S, Ds, S, S, S, S, S
-    strategy->soft_totals[DEALER_IDX(2)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(3)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(4)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(5)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(6)][SOFT_IDX(19)] = SOFT_DOUBLE_OR_STAND;
-    strategy->soft_totals[DEALER_IDX(7)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(8)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(9)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(10)][SOFT_IDX(19)] = SOFT_STAND;
-    strategy->soft_totals[DEALER_IDX(11)][SOFT_IDX(19)] = SOFT_STAND;
-
-    // A-9 (20): S, S, S, S, S, S, S, S, S, S
-    for (int d = 0; d < 10; d++) {
-        strategy->soft_totals[d][SOFT_IDX(20)] = SOFT_STAND;
-    }
-
-    // =======================================================================
-    // PAIR SPLITTING (pairs vs dealer 2-11)
-    // =======================================================================
-
-    // 2-2: Y/N, Y/N, Y, Y, Y, Y, N, N, N, N
-    strategy->pairs[DEALER_IDX(2)][PAIR_IDX_2] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(3)][PAIR_IDX_2] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(4)][PAIR_IDX_2] = YES;
-    strategy->pairs[DEALER_IDX(5)][PAIR_IDX_2] = YES;
-    strategy->pairs[DEALER_IDX(6)][PAIR_IDX_2] = YES;
-    strategy->pairs[DEALER_IDX(7)][PAIR_IDX_2] = YES;
-    strategy->pairs[DEALER_IDX(8)][PAIR_IDX_2] = NO;
-    strategy->pairs[DEALER_IDX(9)][PAIR_IDX_2] = NO;
-    strategy->pairs[DEALER_IDX(10)][PAIR_IDX_2] = NO;
-    strategy->pairs[DEALER_IDX(11)][PAIR_IDX_2] = NO;
-
-    // 3-3: Y/N, Y/N, Y, Y, Y, Y, N, N, N, N (same as 2-2)
-    strategy->pairs[DEALER_IDX(2)][PAIR_IDX_3] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(3)][PAIR_IDX_3] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(4)][PAIR_IDX_3] = YES;
-    strategy->pairs[DEALER_IDX(5)][PAIR_IDX_3] = YES;
-    strategy->pairs[DEALER_IDX(6)][PAIR_IDX_3] = YES;
-    strategy->pairs[DEALER_IDX(7)][PAIR_IDX_3] = YES;
-    strategy->pairs[DEALER_IDX(8)][PAIR_IDX_3] = NO;
-    strategy->pairs[DEALER_IDX(9)][PAIR_IDX_3] = NO;
-    strategy->pairs[DEALER_IDX(10)][PAIR_IDX_3] = NO;
-    strategy->pairs[DEALER_IDX(11)][PAIR_IDX_3] = NO;
-
-    // 4-4: N, N, N, Y/N, Y/N, N, N, N, N, N
-    strategy->pairs[DEALER_IDX(2)][PAIR_IDX_4] = NO;
-    strategy->pairs[DEALER_IDX(3)][PAIR_IDX_4] = NO;
-    strategy->pairs[DEALER_IDX(4)][PAIR_IDX_4] = NO;
-    strategy->pairs[DEALER_IDX(5)][PAIR_IDX_4] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(6)][PAIR_IDX_4] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(7)][PAIR_IDX_4] = NO;
-    strategy->pairs[DEALER_IDX(8)][PAIR_IDX_4] = NO;
-    strategy->pairs[DEALER_IDX(9)][PAIR_IDX_4] = NO;
-    strategy->pairs[DEALER_IDX(10)][PAIR_IDX_4] = NO;
-    strategy->pairs[DEALER_IDX(11)][PAIR_IDX_4] = NO;
-
-    // 5-5: N, N, N, N, N, N, N, N, N, N (never split 5s)
-    for (int d = 0; d < 10; d++) {
-        strategy->pairs[d][PAIR_IDX_5] = NO;
-    }
-
-    // 6-6: Y/N, Y/N, Y/N, Y/N, Y/N, N, N, N, N, N
-    strategy->pairs[DEALER_IDX(2)][PAIR_IDX_6] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(3)][PAIR_IDX_6] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(4)][PAIR_IDX_6] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(5)][PAIR_IDX_6] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(6)][PAIR_IDX_6] = YES_IF_SPLIT_OFFERED;
-    strategy->pairs[DEALER_IDX(7)][PAIR_IDX_6] = NO;
-    strategy->pairs[DEALER_IDX(8)][PAIR_IDX_6] = NO;
-    strategy->pairs[DEALER_IDX(9)][PAIR_IDX_6] = NO;
-    strategy->pairs[DEALER_IDX(10)][PAIR_IDX_6] = NO;
-    strategy->pairs[DEALER_IDX(11)][PAIR_IDX_6] = NO;
-
-    // 7-7: Y, Y, Y, Y, Y, Y, N, N, N, N
-    strategy->pairs[DEALER_IDX(2)][PAIR_IDX_7] = YES;
-    strategy->pairs[DEALER_IDX(3)][PAIR_IDX_7] = YES;
-    strategy->pairs[DEALER_IDX(4)][PAIR_IDX_7] = YES;
-    strategy->pairs[DEALER_IDX(5)][PAIR_IDX_7] = YES;
-    strategy->pairs[DEALER_IDX(6)][PAIR_IDX_7] = YES;
-    strategy->pairs[DEALER_IDX(7)][PAIR_IDX_7] = YES;
-    strategy->pairs[DEALER_IDX(8)][PAIR_IDX_7] = NO;
-    strategy->pairs[DEALER_IDX(9)][PAIR_IDX_7] = NO;
-    strategy->pairs[DEALER_IDX(10)][PAIR_IDX_7] = NO;
-    strategy->pairs[DEALER_IDX(11)][PAIR_IDX_7] = NO;
-
-    // 8-8: Y, Y, Y, Y, Y, Y, Y, Y, Y, Y (always split 8s)
-    for (int d = 0; d < 10; d++) {
-        strategy->pairs[d][PAIR_IDX_8] = YES;
-    }
-
-    // 9-9: Y, Y, Y, Y, Y, N, Y, Y, N, N
-    strategy->pairs[DEALER_IDX(2)][PAIR_IDX_9] = YES;
-    strategy->pairs[DEALER_IDX(3)][PAIR_IDX_9] = YES;
-    strategy->pairs[DEALER_IDX(4)][PAIR_IDX_9] = YES;
-    strategy->pairs[DEALER_IDX(5)][PAIR_IDX_9] = YES;
-    strategy->pairs[DEALER_IDX(6)][PAIR_IDX_9] = YES;
-    strategy->pairs[DEALER_IDX(7)][PAIR_IDX_9] = NO;
-    strategy->pairs[DEALER_IDX(8)][PAIR_IDX_9] = YES;
-    strategy->pairs[DEALER_IDX(9)][PAIR_IDX_9] = YES;
-    strategy->pairs[DEALER_IDX(10)][PAIR_IDX_9] = NO;
-    strategy->pairs[DEALER_IDX(11)][PAIR_IDX_9] = NO;
-
-    // T-T: N, N, N, N, N, N, N, N, N, N (never split 10s)
-    for (int d = 0; d < 10; d++) {
-        strategy->pairs[d][PAIR_IDX_T] = NO;
-    }
+void basic_strategy_init(BasicStrategy* strategy) {
+    basic_strategy_load(strategy, STRATEGY_DEFAULT_CHART);
+}
 
-    // A-A: Y, Y, Y, Y, Y, Y, Y, Y, Y, Y (always split Aces)
-    for (int d = 0; d < 10; d++) {
-        strategy->pairs[d][PAIR_IDX_A] = YES;
+// Copies a compiled chart; leaves the strategy untouched for an unknown name
+bool basic_strategy_load(BasicStrategy* strategy, const char* chart_name) {
+    for (int c = 0; c < STRATEGY_NUM_CHARTS; c++) {
+        if (strcmp(strategy_charts[c].name, chart_name) == 0) {
+            *strategy = strategy_charts[c].strategy;
+            return true;
+        }
     }
+    return false;
+}
 
-    // =======================================================================
-    // LATE SURRENDER (player 14, 15, 16 vs dealer 2-11)
-    // =======================================================================
-
-    // Initialize all to false
-    for (int d = 0; d < 10; d++) {
-        strategy->surrender[d][SUR_IDX_14] = false;
-        strategy->surrender[d][SUR_IDX_15] = false;
-        strategy->surrender[d][SUR_IDX_16] = false;
-    }
+int basic_strategy_num_charts(void) {
+    return STRATEGY_NUM_CHARTS;
+}
 
-    // 16 vs 9, 10, A: surrender
-    strategy->surrender[DEALER_IDX(9)][SUR_IDX_16] = true;
-    strategy->surrender[DEALER_IDX(10)][SUR_IDX_16] = true;
-    strategy->surrender[DEALER_IDX(11)][SUR_IDX_16] = true;
+const char* basic_strategy_chart_name(int chart) {
+    return chart >= 0 && chart < STRATEGY_NUM_CHARTS ? strategy_charts[chart].name : NULL;
+}
 
-    // 15 vs 10: surrender
-    strategy->surrender[DEALER_IDX(10)][SUR_IDX_15] = true;
+// Loads the compiled chart made for these rules and returns its name. The
+// charts differ on the deck count (single, double or 4-8 decks) and the
+// dealer's soft 17. Double after split and surrender are applied by
+// get_basic_strategy_action() from the rules themselves (Yd pair cells,
+// surrender only offered when allowed), so a DAS/LS chart plays no-DAS and
+// no-LS rules the way their own charts would. *exact (NULL = don't care) is
+// false when no chart is made for the rules (3 or more than 8 decks, no peek,
+// no hole card) and the nearest one was loaded instead.
+const char* basic_strategy_for_rules(BasicStrategy* strategy, const Rules* rules, bool* exact) {
+    bool h17 = rules->dealer_hits_soft_17;
+    const char* chart_name;
+    if (rules->num_decks <= 1) {
+        chart_name = h17 ? "1deck_h17_das_ls" : "1deck_s17_das_ls";
+    } else if (rules->num_decks <= 2) {
+        chart_name = h17 ? "2deck_h17_das_ls" : "2deck_s17_das_ls";
+    } else {
+        chart_name = h17 ? "h17_das_ls" : "s17_das_ls";
+    }
+    bool made_for_rules = (rules->num_decks == 1 || rules->num_decks == 2 ||
+                           (rules->num_decks >= 4 && rules->num_decks <= 8)) &&
+                          rules->dealer_peeks_blackjack && !rules->european_no_hole_card;
+
+    if (!basic_strategy_load(strategy, chart_name)) {
+        chart_name = STRATEGY_DEFAULT_CHART;
+        basic_strategy_load(strategy, chart_name);
+        made_for_rules = false;
+    }
+    if (exact != NULL) {
+        *exact = made_for_rules;
+    }
+    return chart_name;
 }
 
-PlayerAction get_basic_strategy_action(Hand* player_hand, int dealer_up_card, Rules* rules, BasicStrategy* strategy, bool can_split, bool can_double, bool can_surrender) {
+PlayerAction get_basic_strategy_action(Hand* player_hand, int dealer_up_card, Rules* rules, const BasicStrategy* strategy, bool can_split, bool can_double, bool can_surrender) {
     int player_hand_value = hand_get_value(player_hand);
     int dealer_up_card_value = card_value(dealer_up_card);
     int dealer_idx = DEALER_IDX(dealer_up_card_value);
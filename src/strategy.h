@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include "hand.h"
 #include "rules.h"
 #include "game.h"
@@ -17,13 +18,25 @@ typedef enum {
     SOFT_DOUBLE_OR_STAND
 } SoftHandPlayerAction;
 
+#define STRATEGY_DEFAULT_CHART "default"
+
+// One byte per cell, indexed [dealer upcard][player hand]. Filled from the
+// charts in charts/, which tools/chartc.c compiles into static const tables.
 typedef struct {
-    PlayerAction hard_totals[10][9];
-    SoftHandPlayerAction soft_totals[10][8];
-    SplitAction pairs[10][10];    
+    uint8_t hard_totals[10][9];     // PlayerAction
+    uint8_t soft_totals[10][8];     // SoftHandPlayerAction
+    uint8_t pairs[10][10];          // SplitAction
     bool surrender[10][3];
 } BasicStrategy;
 
 void basic_strategy_init(BasicStrategy* basic_strategy);
 
-PlayerAction get_basic_strategy_action(Hand* player_hand, int dealer_up_card, Rules* rules, BasicStrategy* strategy, bool can_split, bool can_double, bool can_surrender);
\ No newline at end of file
+bool basic_strategy_load(BasicStrategy* basic_strategy, const char* chart_name);
+
+int basic_strategy_num_charts(void);
+
+const char* basic_strategy_chart_name(int chart);
+
+const char* basic_strategy_for_rules(BasicStrategy* basic_strategy, const Rules* rules, bool* exact);
+
+PlayerAction get_basic_strategy_action(Hand* player_hand, int dealer_up_card, Rules* rules, const BasicStrategy* strategy, bool can_split, bool can_double, bool can_surrender);
\ No newline at end of file
@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 200809L
+#include "strategy_file.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CRC32_POLYNOMIAL 0xedb88320u   // IEEE 802.3, reflected
+
+// Records are read in place, so their layout is the file format
+_Static_assert(sizeof(StrategyFileHeader) == 24, "StrategyFileHeader layout changed");
+_Static_assert(sizeof(BasicStrategy) == 300, "BasicStrategy layout changed: bump STRATEGY_FILE_VERSION");
+_Static_assert(sizeof(StrategyRecord) == CHART_NAME_LENGTH + sizeof(BasicStrategy), "StrategyRecord has padding");
+
+// Bitwise CRC-32: a file of a few hundred strategies is ~100 KB, checked once per open
+uint32_t strategy_file_checksum(const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32_POLYNOMIAL & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+bool strategy_file_save(const char* path, const StrategyRecord* records, int num_strategies) {
+    StrategyFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STRATEGY_FILE_MAGIC, STRATEGY_FILE_MAGIC_LENGTH);
+    header.version = STRATEGY_FILE_VERSION;
+    header.record_size = sizeof(StrategyRecord);
+    header.num_strategies = (uint32_t)num_strategies;
+    header.checksum = strategy_file_checksum(records, sizeof(StrategyRecord) * num_strategies);
+
+    FILE* out = fopen(path, "wb");
+    if (out == NULL) {
+        perror(path);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(records, sizeof(StrategyRecord), num_strategies, out) == (size_t)num_strategies;
+    ok = fclose(out) == 0 && ok;
+    if (!ok) {
+        perror(path);
+        remove(path);
+    }
+    return ok;
+}
+
+static bool file_error(const char* path, const char* reason) {
+    fprintf(stderr, "%s: %s\n", path, reason);
+    return false;
+}
+
+static bool validate(const char* path, const void* mapping, size_t size) {
+    const StrategyFileHeader* header = mapping;
+    if (size < sizeof(StrategyFileHeader) || memcmp(header->magic, STRATEGY_FILE_MAGIC, STRATEGY_FILE_MAGIC_LENGTH) != 0) {
+        return file_error(path, "not a strategy file");
+    }
+    if (header->version != STRATEGY_FILE_VERSION) {
+        return file_error(path, "unsupported strategy file version");
+    }
+    if (header->record_size != sizeof(StrategyRecord)) {
+        return file_error(path, "strategy records are a different size; rebuild the file");
+    }
+    if (size != sizeof(StrategyFileHeader) + (size_t)header->num_strategies * sizeof(StrategyRecord)) {
+        return file_error(path, "truncated strategy file");
+    }
+
+    const StrategyRecord* records = (const StrategyRecord*)(header + 1);
+    if (strategy_file_checksum(records, size - sizeof(StrategyFileHeader)) != header->checksum) {
+        return file_error(path, "checksum mismatch");
+    }
+    for (uint32_t r = 0; r < header->num_strategies; r++) {
+        if (memchr(records[r].name, '\0', CHART_NAME_LENGTH) == NULL) {
+            return file_error(path, "unterminated strategy name");
+        }
+        if (!chart_strategy_valid(&records[r].strategy)) {
+            return file_error(path, "strategy cell out of range");
+        }
+    }
+    return true;
+}
+
+// Maps the file read-only and checks it once; the records are then used in place
+bool strategy_file_open(StrategyFile* file, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0) {
+        close(fd);
+        return file_error(path, "not a strategy file");
+    }
+
+    size_t size = (size_t)status.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+
+    if (!validate(path, mapping, size)) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    const StrategyFileHeader* header = mapping;
+    file->records = (const StrategyRecord*)(header + 1);
+    file->num_strategies = (int)header->num_strategies;
+    file->mapping = mapping;
+    file->mapping_size = size;
+    return true;
+}
+
+const BasicStrategy* strategy_file_find(const StrategyFile* file, const char* name) {
+    for (int r = 0; r < file->num_strategies; r++) {
+        if (strcmp(file->records[r].name, name) == 0) {
+            return &file->records[r].strategy;
+        }
+    }
+    return NULL;
+}
+
+void strategy_file_close(StrategyFile* file) {
+    if (file->mapping != NULL) {
+        munmap(file->mapping, file->mapping_size);
+    }
+    file->records = NULL;
+    file->num_strategies = 0;
+    file->mapping = NULL;
+    file->mapping_size = 0;
+}
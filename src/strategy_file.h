@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "strategy.h"
+#include "chart.h"
+
+#define STRATEGY_FILE_MAGIC "BJSTRATS"   // First 8 bytes; not terminated in the file
+#define STRATEGY_FILE_MAGIC_LENGTH 8
+#define STRATEGY_FILE_VERSION 1
+
+// A header followed by num_strategies records back to back. Fields are
+// fixed-width and in host byte order (little-endian on every machine we run
+// on), and BasicStrategy is all bytes, so a mapped file is used in place:
+// no parsing, no copying, and pages are shared between jobs reading the same
+// file.
+typedef struct {
+    char magic[STRATEGY_FILE_MAGIC_LENGTH];
+    uint32_t version;
+    uint32_t record_size;       // sizeof(StrategyRecord): rejects files from another BasicStrategy layout
+    uint32_t num_strategies;
+    uint32_t checksum;          // CRC-32 of every record
+} StrategyFileHeader;
+
+typedef struct {
+    char name[CHART_NAME_LENGTH];   // Terminated, zero padded
+    BasicStrategy strategy;
+} StrategyRecord;
+
+typedef struct {
+    const StrategyRecord* records;  // Into the mapping; valid until strategy_file_close()
+    int num_strategies;
+    void* mapping;
+    size_t mapping_size;
+} StrategyFile;
+
+uint32_t strategy_file_checksum(const void* data, size_t size);
+
+bool strategy_file_save(const char* path, const StrategyRecord* records, int num_strategies);
+
+bool strategy_file_open(StrategyFile* file, const char* path);
+
+const BasicStrategy* strategy_file_find(const StrategyFile* file, const char* name);
+
+void strategy_file_close(StrategyFile* file);
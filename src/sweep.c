@@ -0,0 +1,354 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "sweep.h"
+#include "pool.h"
+
+#define LINE_LENGTH 1024
+#define TOKEN_SEPARATORS " \t\r\n"
+
+typedef enum {
+    AXIS_BOOL,
+    AXIS_INT,
+    AXIS_DOUBLE
+} SweepAxisKind;
+
+typedef struct {
+    const char* key;
+    size_t offset;               // Into Rules
+    SweepAxisKind kind;
+    double min;
+    double max;
+} SweepAxis;
+
+static const SweepAxis axes[] = {
+    { "decks",       offsetof(Rules, num_decks),              AXIS_INT,    1,    8    },
+    { "h17",         offsetof(Rules, dealer_hits_soft_17),    AXIS_BOOL,   0,    1    },
+    { "das",         offsetof(Rules, double_after_split),     AXIS_BOOL,   0,    1    },
+    { "surrender",   offsetof(Rules, late_surrender_allowed), AXIS_BOOL,   0,    1    },
+    { "peek",        offsetof(Rules, dealer_peeks_blackjack), AXIS_BOOL,   0,    1    },
+    { "splits",      offsetof(Rules, max_splits),             AXIS_INT,    0,    3    },
+    { "rsa",         offsetof(Rules, can_resplit_aces),       AXIS_BOOL,   0,    1    },
+    { "payout",      offsetof(Rules, blackjack_payout),       AXIS_DOUBLE, 1.0,  2.0  },
+    { "penetration", offsetof(Rules, shoe_penetration),       AXIS_DOUBLE, 0.25, 0.95 },
+};
+
+_Static_assert(sizeof(axes) / sizeof(axes[0]) == SWEEP_NUM_AXES, "one table row per sweep axis");
+
+// Streams finished configurations in order from whichever worker merged them
+typedef struct {
+    Sweep* sweep;
+    FILE* out;
+    bool* done;
+    int next;                    // First configuration not printed yet
+    pthread_mutex_t lock;
+} SweepProgress;
+
+static int find_axis(const char* key) {
+    for (int a = 0; a < SWEEP_NUM_AXES; a++) {
+        if (strcmp(axes[a].key, key) == 0) {
+            return a;
+        }
+    }
+    return -1;
+}
+
+// A number, or a ratio like 3:2 or 6:5 for payouts
+static bool parse_value(const char* text, double* value) {
+    char* end;
+    *value = strtod(text, &end);
+    if (end == text) {
+        return false;
+    }
+    if (*end == ':') {
+        const char* denominator_text = end + 1;
+        double denominator = strtod(denominator_text, &end);
+        if (end == denominator_text || denominator <= 0) {
+            return false;
+        }
+        *value /= denominator;
+    }
+    return *end == '\0';
+}
+
+static bool parse_axis(const char* token, const char* source, SweepGrid* grid) {
+    char key[32];
+    const char* equals = strchr(token, '=');
+    size_t key_length = equals != NULL ? (size_t)(equals - token) : 0;
+    if (key_length == 0 || key_length >= sizeof(key)) {
+        fprintf(stderr, "%s: expected KEY=VALUE[,VALUE...], got '%s'\n", source, token);
+        return false;
+    }
+    memcpy(key, token, key_length);
+    key[key_length] = '\0';
+
+    int a = find_axis(key);
+    if (a < 0) {
+        fprintf(stderr, "%s: unknown rule '%s'\n", source, key);
+        return false;
+    }
+    if (grid->num_values[a] > 0) {
+        fprintf(stderr, "%s: %s given twice\n", source, key);
+        return false;
+    }
+
+    char values[LINE_LENGTH];
+    snprintf(values, sizeof(values), "%s", equals + 1);
+    char* saved;
+    for (char* text = strtok_r(values, ",", &saved); text != NULL; text = strtok_r(NULL, ",", &saved)) {
+        double value;
+        if (!parse_value(text, &value) || value < axes[a].min || value > axes[a].max ||
+            (axes[a].kind != AXIS_DOUBLE && value != (int)value)) {
+            fprintf(stderr, "%s: %s=%s is not %s from %g to %g\n", source, key, text,
+                    axes[a].kind == AXIS_DOUBLE ? "a number" : "a whole number", axes[a].min, axes[a].max);
+            return false;
+        }
+        if (grid->num_values[a] == SWEEP_MAX_VALUES) {
+            fprintf(stderr, "%s: %s has more than %d values\n", source, key, SWEEP_MAX_VALUES);
+            return false;
+        }
+        grid->values[a][grid->num_values[a]++] = value;
+    }
+
+    if (grid->num_values[a] == 0) {
+        fprintf(stderr, "%s: %s has no values\n", source, key);
+        return false;
+    }
+    return true;
+}
+
+static void set_axis(Rules* rules, int a, double value) {
+    char* field = (char*)rules + axes[a].offset;
+    switch (axes[a].kind) {
+        case AXIS_BOOL:
+            *(bool*)field = value != 0;
+            break;
+        case AXIS_INT:
+            *(int*)field = (int)value;
+            break;
+        case AXIS_DOUBLE:
+            *(double*)field = value;
+            break;
+    }
+}
+
+static bool add_entry(Sweep* sweep, const Rules* rules) {
+    if (sweep->num_entries == sweep->capacity) {
+        int capacity = sweep->capacity > 0 ? sweep->capacity * 2 : 16;
+        SweepEntry* entries = realloc(sweep->entries, sizeof(SweepEntry) * capacity);
+        if (entries == NULL) {
+            return false;
+        }
+        sweep->entries = entries;
+        sweep->capacity = capacity;
+    }
+    SweepEntry* entry = &sweep->entries[sweep->num_entries++];
+    memset(entry, 0, sizeof(*entry));
+    entry->rules = *rules;
+    return true;
+}
+
+static void print_finished(Pool* pool, int job, void* context) {
+    SweepProgress* progress = context;
+    pthread_mutex_lock(&progress->lock);
+    for (int e = 0; e < progress->sweep->num_entries; e++) {
+        if (progress->sweep->entries[e].job == job) {
+            progress->sweep->entries[e].results = *pool_job_results(pool, job);
+            progress->done[e] = true;
+        }
+    }
+    while (progress->next < progress->sweep->num_entries && progress->done[progress->next]) {
+        if (progress->out != NULL) {
+            sweep_print_entry(progress->out, progress->sweep, &progress->sweep->entries[progress->next]);
+            fflush(progress->out);
+        }
+        progress->next++;
+    }
+    pthread_mutex_unlock(&progress->lock);
+}
+
+void sweep_init(Sweep* sweep) {
+    memset(sweep, 0, sizeof(*sweep));
+    sweep->rounds = SWEEP_DEFAULT_ROUNDS;
+    sweep->seed = 20240601;
+}
+
+bool sweep_parse_grid(const char* text, const char* source, SweepGrid* grid) {
+    memset(grid, 0, sizeof(*grid));
+
+    char line[LINE_LENGTH];
+    snprintf(line, sizeof(line), "%s", text);
+    char* saved;
+    for (char* token = strtok_r(line, TOKEN_SEPARATORS, &saved); token != NULL;
+         token = strtok_r(NULL, TOKEN_SEPARATORS, &saved)) {
+        if (!parse_axis(token, source, grid)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every combination, the last axis changing fastest
+bool sweep_add_grid(Sweep* sweep, const SweepGrid* grid) {
+    int index[SWEEP_NUM_AXES] = {0};
+    for (;;) {
+        Rules rules;
+        rules_init(&rules);
+        for (int a = 0; a < SWEEP_NUM_AXES; a++) {
+            if (grid->num_values[a] > 0) {
+                set_axis(&rules, a, grid->values[a][index[a]]);
+            }
+        }
+        if (!add_entry(sweep, &rules)) {
+            return false;
+        }
+
+        int a = SWEEP_NUM_AXES - 1;
+        while (a >= 0 && ++index[a] >= grid->num_values[a]) {
+            index[a] = 0;
+            a--;
+        }
+        if (a < 0) {
+            return true;
+        }
+    }
+}
+
+bool sweep_add_list(Sweep* sweep, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    char line[LINE_LENGTH];
+    char source[LINE_LENGTH];
+    int line_number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        const char* start = line + strspn(line, TOKEN_SEPARATORS);
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+
+        SweepGrid grid;
+        snprintf(source, sizeof(source), "%s:%d", path, line_number);
+        ok = sweep_parse_grid(start, source, &grid);
+        if (ok && !sweep_add_grid(sweep, &grid)) {
+            fprintf(stderr, "%s: out of memory\n", source);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+// A fresh shoe every round never reaches the cut card, so penetration only
+// separates jobs that deal through the shoe
+static bool same_job(const Sweep* sweep, const Rules* a, const Rules* b) {
+    Rules b_dealt = *b;
+    if (!sweep->through_shoe) {
+        b_dealt.shoe_penetration = a->shoe_penetration;
+    }
+    return rules_same_play(a, &b_dealt);
+}
+
+bool sweep_run(Sweep* sweep, FILE* out) {
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+
+    SweepProgress progress = { sweep, out, calloc(sweep->num_entries, sizeof(bool)), 0, PTHREAD_MUTEX_INITIALIZER };
+    if (progress.done == NULL) {
+        return false;
+    }
+    Pool pool;
+    pool_init(&pool, sweep->num_threads);
+    pool.job_done = print_finished;
+    pool.job_done_context = &progress;
+
+    // Same seed and shoes for every configuration (common random numbers).
+    // A configuration without a job would never be printed, so it fails the run.
+    bool ok = true;
+    for (int e = 0; ok && e < sweep->num_entries; e++) {
+        SweepEntry* entry = &sweep->entries[e];
+        entry->job = -1;
+        for (int earlier = 0; earlier < e && entry->job < 0; earlier++) {
+            if (same_job(sweep, &sweep->entries[earlier].rules, &entry->rules)) {
+                entry->job = sweep->entries[earlier].job;
+                entry->chart = sweep->entries[earlier].chart;
+                entry->exact_chart = sweep->entries[earlier].exact_chart;
+            }
+        }
+        if (entry->job >= 0) {
+            continue;
+        }
+
+        SimulationConfig config = {0};
+        config.rules = entry->rules;
+        entry->chart = basic_strategy_for_rules(&config.strategy, &entry->rules, &entry->exact_chart);
+        config.num_hands = sweep->rounds;
+        config.bet_per_hand = 1.0;
+        config.seed = sweep->seed;
+        if (sweep->through_shoe) {
+            // Only counted shoes are dealt down to the cut card; bets stay flat
+            config.count_systems = &hi_lo;
+            config.num_count_systems = 1;
+        }
+        entry->job = pool_add_job(&pool, &config, SWEEP_ROUNDS_PER_TASK);
+        ok = entry->job >= 0;
+    }
+    sweep->num_jobs = pool.num_jobs;
+
+    ok = ok && pool_run(&pool);
+    pool_destroy(&pool);
+    pthread_mutex_destroy(&progress.lock);
+    free(progress.done);
+    return ok;
+}
+
+void sweep_print_header(FILE* out) {
+    fprintf(out, "Decks  Soft17  DAS  LS   Peek  Splits  RSA  Payout  Pen    Chart              Rounds      Edge       SE\n");
+}
+
+void sweep_print_entry(FILE* out, const Sweep* sweep, SweepEntry* entry) {
+    const Rules* rules = &entry->rules;
+    PayoutVariant variant;
+    PayoutScore score;
+    payout_variant_from_rules(&variant, rules);
+    payout_score(&entry->results.payouts, &variant, &score);
+
+    char chart[32] = "-";
+    if (entry->chart != NULL) {
+        snprintf(chart, sizeof(chart), "%s%s", entry->chart, entry->exact_chart ? "" : "*");
+    }
+
+    char penetration[8] = "-";
+    if (sweep->through_shoe) {
+        snprintf(penetration, sizeof(penetration), "%.2f", rules->shoe_penetration);
+    }
+
+    // The house edge per initial bet, the figure rule comparisons quote
+    fprintf(out, "%5d  %-6s  %-3s  %-3s  %-4s  %6d  %-3s  %6.3f  %-5s  %-17s %9d  %+7.3f%%  %6.3f%%\n",
+            rules->num_decks,
+            rules->dealer_hits_soft_17 ? "H17" : "S17",
+            rules->double_after_split ? "yes" : "no",
+            rules->late_surrender_allowed ? "yes" : "no",
+            rules->dealer_peeks_blackjack ? "yes" : "no",
+            rules->max_splits,
+            rules->can_resplit_aces ? "yes" : "no",
+            rules->blackjack_payout,
+            penetration,
+            chart,
+            entry->results.hands_played,
+            -100.0 * score.ev,
+            100.0 * score.standard_error);
+}
+
+void sweep_destroy(Sweep* sweep) {
+    free(sweep->entries);
+    memset(sweep, 0, sizeof(*sweep));
+}
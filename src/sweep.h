@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "rules.h"
+#include "simulation.h"
+
+#define SWEEP_NUM_AXES 9
+#define SWEEP_MAX_VALUES 16              // Per axis
+#define SWEEP_DEFAULT_ROUNDS 4000000
+#define SWEEP_ROUNDS_PER_TASK 65536
+
+// Values for the Rules fields a sweep varies, read from text like
+// "decks=1,2,6,8 h17=0,1 payout=3:2,6:5". A grid stands for every combination
+// of its values; an axis it doesn't name keeps the rules_init() setting.
+typedef struct {
+    double values[SWEEP_NUM_AXES][SWEEP_MAX_VALUES];
+    int num_values[SWEEP_NUM_AXES];
+} SweepGrid;
+
+typedef struct {
+    Rules rules;
+    const char* chart;                   // Picked by basic_strategy_for_rules
+    bool exact_chart;                    // False = no chart made for these rules; printed with a *
+    int job;                             // Shared by every configuration that differs only in payouts
+    SimulationResults results;           // The job's, scored with this configuration's payouts
+} SweepEntry;
+
+// Every configuration that plays differently is one pool job, and all of them
+// deal the same shoes, so the differences between lines are mostly the rules,
+// not the cards. Payout variants of a configuration are rescored from its
+// job's outcome categories instead of being simulated again.
+typedef struct {
+    SweepEntry* entries;
+    int num_entries;
+    int capacity;
+    int rounds;                          // Per configuration
+    bool through_shoe;                   // Deal each shoe down to its penetration; false = a fresh shoe every round
+    int seed;                            // Nonzero
+    int num_threads;
+    int num_jobs;                        // Simulations the last sweep_run needed
+} Sweep;
+
+void sweep_init(Sweep* sweep);
+
+// source names the text in error messages, such as "path:line"
+bool sweep_parse_grid(const char* text, const char* source, SweepGrid* grid);
+
+// false if out of memory; the configurations added before then stay
+bool sweep_add_grid(Sweep* sweep, const SweepGrid* grid);
+
+// One grid per line; blank lines and lines starting with # are skipped
+bool sweep_add_list(Sweep* sweep, const char* path);
+
+// Writes each configuration's line to out (NULL = none) as soon as it and
+// every configuration before it are done; false if the pool couldn't take or
+// run it all
+bool sweep_run(Sweep* sweep, FILE* out);
+
+void sweep_print_header(FILE* out);
+
+void sweep_print_entry(FILE* out, const Sweep* sweep, SweepEntry* entry);
+
+void sweep_destroy(Sweep* sweep);
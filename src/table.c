@@ -0,0 +1,169 @@
+#include "table.h"
+#include "dealer.h"
+#include "deck.h"
+#include "game.h"
+
+#define DEFAULT_HAND_SIZE 2
+
+static void copy_hand(Hand* dest, Hand* src) {
+    dest->num_cards = 0;
+    for (int i = 0; i < src->num_cards; i++) {
+        hand_add_card(dest, src->cards[i]);
+    }
+}
+
+static bool seat_is_live(GameState* seat) {
+    return !seat->surrendered && !simulation_all_hands_busted(seat);
+}
+
+static int observe_hand(CountTracker* tracker, bool counting, Hand* hand) {
+    if (counting) {
+        for (int i = 0; i < hand->num_cards; i++) {
+            count_tracker_observe(tracker, hand->cards[i]);
+        }
+    }
+
+    return hand->num_cards;
+}
+
+bool table_config_valid(const TableConfig* table_config) {
+    if (table_config->num_seats < 1 || table_config->num_seats > TABLE_MAX_SEATS || table_config->num_rounds < 0 ||
+        table_config->num_count_systems < 0 || table_config->num_count_systems > COUNT_MAX_SYSTEMS) {
+        return false;
+    }
+
+    bool counting = table_config->count_systems != NULL && table_config->num_count_systems > 0;
+    for (int s = 0; s < table_config->num_seats; s++) {
+        const SeatConfig* seat = &table_config->seats[s];
+        if (counting && seat->bet_ramp != NULL &&
+            (seat->count_system < 0 || seat->count_system >= table_config->num_count_systems)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One shoe, one dealer and up to seven seats. Each round is dealt in casino
+// order (first card to every seat, dealer upcard, second card to every seat,
+// hole card), every seat plays its own strategy in turn, and the dealer
+// plays once for the whole table. Each seat gets a GameState that draws from
+// the shared shoe and sees a copy of the dealer's hand.
+bool table_run(TableConfig* table_config, TableResults* table_results) {
+    if (!table_config_valid(table_config)) {
+        return false;
+    }
+
+    bool counting = table_config->count_systems != NULL && table_config->num_count_systems > 0;
+    int num_seats = table_config->num_seats;
+
+    Deck shoe;
+    deck_init(&shoe, table_config->rules.num_decks);
+    deck_set_mode(&shoe, DECK_SHUFFLE_LAZY);
+    if (table_config->seed != 0) {
+        deck_seed(&shoe, table_config->seed, table_config->first_shoe);
+    }
+    deck_shuffle(&shoe);
+    int reshuffle_at = (int)(table_config->rules.shoe_penetration * shoe.total_cards);
+
+    Hand dealer_hand;
+    hand_init(&dealer_hand);
+    DealerTable dealer_table;
+    dealer_table_init(&dealer_table, &table_config->rules);
+
+    GameState seats[TABLE_MAX_SEATS];
+    SimulationConfig seat_configs[TABLE_MAX_SEATS];
+    for (int s = 0; s < num_seats; s++) {
+        game_init_shared(&seats[s], &table_config->rules, table_config->seats[s].bet_per_hand, &shoe);
+
+        SimulationConfig seat_config = {0};
+        seat_config.rules = table_config->rules;
+        seat_config.strategy = table_config->seats[s].strategy;
+        seat_config.bet_per_hand = table_config->seats[s].bet_per_hand;
+        seat_config.bet_ramp = table_config->seats[s].bet_ramp;
+        seat_configs[s] = seat_config;
+    }
+
+    CountTracker tracker;
+    int count_buckets[COUNT_MAX_SYSTEMS];
+    if (counting) {
+        count_tracker_init(&tracker, table_config->count_systems, table_config->num_count_systems, table_config->rules.num_decks);
+    }
+
+    for (int round = 0; round < table_config->num_rounds; round++) {
+        if (shoe.position >= reshuffle_at) {
+            deck_shuffle(&shoe);
+            if (counting) {
+                count_tracker_reset(&tracker);
+            }
+        }
+
+        if (counting) {
+            count_tracker_buckets(&tracker, count_buckets);
+        }
+
+        double initial_bets[TABLE_MAX_SEATS];
+        for (int s = 0; s < num_seats; s++) {
+            const SeatConfig* seat = &table_config->seats[s];
+            initial_bets[s] = seat->bet_per_hand;
+            if (counting && seat->bet_ramp != NULL) {
+                initial_bets[s] *= seat->bet_ramp->units[count_buckets[seat->count_system]];
+            }
+            game_reset_round(&seats[s], initial_bets[s]);
+        }
+        dealer_hand.num_cards = 0;
+
+        int round_start_position = shoe.position;
+        for (int i = 0; i < DEFAULT_HAND_SIZE; i++) {
+            for (int s = 0; s < num_seats; s++) {
+                hand_add_card(&seats[s].player_hands[0], deck_deal(&shoe));
+            }
+            hand_add_card(&dealer_hand, deck_deal(&shoe));
+        }
+
+        for (int s = 0; s < num_seats; s++) {
+            seats[s].num_player_hands = 1;
+            copy_hand(&seats[s].dealer_hand, &dealer_hand);
+        }
+
+        bool dealer_has_blackjack = table_config->rules.dealer_peeks_blackjack && hand_is_blackjack(&dealer_hand);
+        bool any_seat_live = false;
+
+        if (!dealer_has_blackjack) {
+            for (int s = 0; s < num_seats; s++) {
+                simulation_play_player_hands(&seats[s], &seat_configs[s], &table_results->seats[s]);
+                any_seat_live = any_seat_live || seat_is_live(&seats[s]);
+            }
+        }
+
+        // The dealer only draws if someone is still waiting on the result
+        if (any_seat_live) {
+            dealer_play(&dealer_table, &dealer_hand, &shoe);
+        }
+
+        int cards_this_round = observe_hand(&tracker, counting, &dealer_hand);
+        for (int s = 0; s < num_seats; s++) {
+            copy_hand(&seats[s].dealer_hand, &dealer_hand);
+            simulation_record_round(&table_results->seats[s], &seats[s], initial_bets[s],
+                                    counting ? count_buckets : NULL, counting ? tracker.num_systems : 0);
+
+            for (int h = 0; h < seats[s].num_player_hands; h++) {
+                cards_this_round += observe_hand(&tracker, counting, &seats[s].player_hands[h]);
+            }
+        }
+
+        if (counting && shoe.position < round_start_position) {
+            // The shoe ran out mid-round and was reshuffled; start counting again
+            count_tracker_reset(&tracker);
+        }
+
+        table_results->rounds_dealt++;
+        table_results->cards_dealt += cards_this_round;
+    }
+
+    for (int s = 0; s < num_seats; s++) {
+        game_destroy(&seats[s]);
+    }
+    hand_destroy(&dealer_hand);
+    deck_destroy(&shoe);
+    return true;
+}
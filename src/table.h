@@ -0,0 +1,40 @@
+#pragma once
+
+#include "rules.h"
+#include "strategy.h"
+#include "counting.h"
+#include "betting.h"
+#include "simulation.h"
+
+#define TABLE_MAX_SEATS 7
+
+typedef struct {
+    BasicStrategy strategy;
+    double bet_per_hand;
+    const BetRamp* bet_ramp;  // NULL = flat bet_per_hand
+    int count_system;         // Index into the table's count_systems that keys bet_ramp
+} SeatConfig;
+
+typedef struct {
+    int num_rounds;
+    Rules rules;
+    int num_seats;                     // 1 to TABLE_MAX_SEATS, dealt left to right
+    SeatConfig seats[TABLE_MAX_SEATS];
+    const CountSystem* count_systems;  // NULL = no counting; the shoe is still cut at shoe_penetration
+    int num_count_systems;
+    uint64_t seed;                     // As in SimulationConfig: nonzero = shoe k is (seed, first_shoe + k)
+    uint64_t first_shoe;
+} TableConfig;
+
+typedef struct {
+    int rounds_dealt;
+    long cards_dealt;
+    SimulationResults seats[TABLE_MAX_SEATS];  // Per seat, count tables keyed by every count system
+} TableResults;
+
+// Seats within 1 to TABLE_MAX_SEATS, and every ramping seat keyed on one of
+// the table's count systems
+bool table_config_valid(const TableConfig* table_config);
+
+// false unless table_config_valid (nothing dealt)
+bool table_run(TableConfig* table_config, TableResults* table_results);
@@ -0,0 +1,37 @@
+#pragma once
+
+// Config and comparison helpers shared by the test programs that run whole
+// simulations (test_lanes, test_pool, test_payout)
+
+#include <assert.h>
+#include <string.h>
+#include "../src/simulation.h"
+
+// Default rules and chart, flat bets of 1, shoes (seed, first_shoe + k)
+static inline void simulation_config_init(SimulationConfig* config, int num_hands, uint64_t seed, uint64_t first_shoe) {
+    SimulationConfig blank = {0};
+    *config = blank;
+    rules_init(&config->rules);
+    basic_strategy_init(&config->strategy);
+    config->num_hands = num_hands;
+    config->bet_per_hand = 1.0;
+    config->seed = seed;
+    config->first_shoe = first_shoe;
+}
+
+// Every tally two runs of the same rounds must agree on, whichever engine or
+// task split produced them
+static inline void assert_same_results(const SimulationResults* a, const SimulationResults* b) {
+    assert(a->hands_played == b->hands_played);
+    assert(a->hands_won == b->hands_won);
+    assert(a->hands_lost == b->hands_lost);
+    assert(a->hands_pushed == b->hands_pushed);
+    assert(a->doubles_taken == b->doubles_taken);
+    assert(a->splits_taken == b->splits_taken);
+    assert(a->total_bet == b->total_bet);
+    assert(a->total_payout == b->total_payout);
+    assert(a->house_edge == b->house_edge);
+    assert(a->rounds_sat_out == b->rounds_sat_out);
+    assert(memcmp(&a->payouts, &b->payouts, sizeof(a->payouts)) == 0);
+    assert(memcmp(a->count_tables, b->count_tables, sizeof(a->count_tables)) == 0);
+}
@@ -0,0 +1,632 @@
+#include <stdio.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/counting.h"
+#include "../src/betting.h"
+#include "../src/simulation.h"
+#include "../src/deck.h"
+#include "../src/eor.h"
+#include "../src/benchmark.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+// ============================================================================
+// COUNT TRACKING TESTS
+// ============================================================================
+
+TEST(hi_lo_is_balanced) {
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+
+    // A full deck counts back to zero
+    int running_count = 0;
+    for (int card = 0; card < 52; card++) {
+        running_count += hi_lo.tags[count_rank_index(card)];
+    }
+    assert(running_count == 0);
+
+    // Face cards share the ten tag
+    assert(count_rank_index(9) == 9);   // 10
+    assert(count_rank_index(10) == 9);  // Jack
+    assert(count_rank_index(25) == 9);  // King of second suit
+}
+
+TEST(tracker_true_count) {
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+
+    CountTracker tracker;
+    count_tracker_init(&tracker, &hi_lo, 1, 2);
+    assert(tracker.total_cards == 104);
+
+    // Deal out one deck worth of small cards: 26 cards, all +1
+    for (int i = 0; i < 26; i++) {
+        count_tracker_observe(&tracker, 1 + (i % 5));  // 2 through 6
+    }
+    assert(count_tracker_running_count(&tracker, 0) == 26);
+
+    // 78 cards left = 1.5 decks, true count = 26 / 1.5
+    double true_count = count_tracker_true_count(&tracker, 0);
+    assert(fabs(true_count - 26.0 / 1.5) < 1e-9);
+
+    // Clamped into the top bucket
+    assert(count_tracker_bucket(&tracker, 0) == COUNT_NUM_BUCKETS - 1);
+
+    count_tracker_reset(&tracker);
+    assert(count_tracker_running_count(&tracker, 0) == 0);
+    assert(count_tracker_bucket(&tracker, 0) == -COUNT_MIN_TRUE_COUNT);
+}
+
+// KO leaves +4 per deck, so it starts at its IRC and is bucketed by running count
+TEST(unbalanced_system_counts_from_its_irc) {
+    CountSystem ko, hi_lo;
+    assert(count_system_by_name("KO", &ko));
+    count_system_hi_lo(&hi_lo);
+    assert(!count_system_is_balanced(&ko));
+    assert(count_system_is_balanced(&hi_lo));
+    assert(count_system_initial_count(&ko, 1) == 0);
+    assert(count_system_initial_count(&ko, 6) == -20);
+    assert(count_system_initial_count(&hi_lo, 6) == 0);
+
+    CountSystem systems[2] = { hi_lo, ko };
+    CountTracker tracker;
+    count_tracker_init(&tracker, systems, 2, 6);
+    assert(count_tracker_running_count(&tracker, 0) == 0);
+    assert(count_tracker_running_count(&tracker, 1) == -20);
+
+    // Five whole decks add KO's +4 a deck, back up to zero
+    for (int deck = 0; deck < 5; deck++) {
+        for (int card = 0; card < 52; card++) {
+            count_tracker_observe(&tracker, card);
+        }
+    }
+    assert(count_tracker_running_count(&tracker, 0) == 0);
+    assert(count_tracker_running_count(&tracker, 1) == 0);
+    count_tracker_observe(&tracker, 3);
+    count_tracker_observe(&tracker, 3);
+    assert(count_tracker_index(&tracker, 1) == 2.0);
+    assert(count_tracker_bucket(&tracker, 1) == count_bucket_for_true_count(2.0));
+    assert(fabs(count_tracker_index(&tracker, 0) - 2.0 / (50.0 / 52.0)) < 1e-9);
+
+    count_tracker_reset(&tracker);
+    assert(count_tracker_running_count(&tracker, 1) == -20);
+    assert(count_tracker_bucket(&tracker, 1) == 0);
+}
+
+TEST(multi_system_tracker_matches_scalar_counts) {
+    CountSystem systems[COUNT_MAX_SYSTEMS];
+    int num_systems = count_system_num_builtin();
+    for (int i = 0; i < num_systems; i++) {
+        count_system_builtin(i, &systems[i]);
+    }
+
+    CountTracker tracker;
+    count_tracker_init(&tracker, systems, num_systems, 1);
+
+    int expected[COUNT_MAX_SYSTEMS] = {0};
+    for (int card = 0; card < 30; card++) {
+        count_tracker_observe(&tracker, card);
+        for (int i = 0; i < num_systems; i++) {
+            expected[i] += systems[i].tags[count_rank_index(card)];
+        }
+    }
+
+    int buckets[COUNT_MAX_SYSTEMS];
+    count_tracker_buckets(&tracker, buckets);
+    for (int i = 0; i < num_systems; i++) {
+        assert(count_tracker_running_count(&tracker, i) == expected[i]);
+        double index = count_system_is_balanced(&systems[i]) ? expected[i] / (22.0 / 52.0) : expected[i];
+        assert(buckets[i] == count_bucket_for_true_count(index));
+    }
+
+    CountSystem zen;
+    assert(count_system_by_name("Zen", &zen));
+    assert(zen.tags[3] == 2);  // Fours count +2
+    assert(!count_system_by_name("No Such Count", &zen));
+}
+
+TEST(true_count_buckets_floor) {
+    assert(count_bucket_true_count(count_bucket_for_true_count(0.0)) == 0);
+    assert(count_bucket_true_count(count_bucket_for_true_count(2.9)) == 2);
+    assert(count_bucket_true_count(count_bucket_for_true_count(-0.5)) == -1);
+    assert(count_bucket_true_count(count_bucket_for_true_count(-50.0)) == COUNT_MIN_TRUE_COUNT);
+}
+
+// ============================================================================
+// BET RAMP SOLVER TESTS
+// ============================================================================
+
+// Synthetic table: EV rises 0.5% per true count from -1% at TC 0, variance 1.3
+static void fill_synthetic_table(CountTable* table) {
+    CountTable empty = {0};
+    *table = empty;
+
+    for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+        int true_count = count_bucket_true_count(b);
+        double ev = -0.01 + 0.005 * true_count;
+        long rounds = 100000 / (1 + true_count * true_count);
+
+        table->buckets[b].rounds = rounds;
+        table->buckets[b].total_result = ev * rounds;
+        table->buckets[b].total_result_squared = (1.3 + ev * ev) * rounds;
+    }
+}
+
+TEST(kelly_ramp_is_monotone_and_clamped) {
+    CountTable table;
+    fill_synthetic_table(&table);
+
+    BetRampSolverConfig solver = {
+        .bankroll = 1000, .min_bet = 1, .max_bet = 12, .bet_increment = 1,
+        .kelly_fraction = 1.0, .max_risk_of_ruin = 0
+    };
+
+    BetRamp ramp;
+    assert(bet_ramp_solve(&table, &solver, &ramp));
+
+    for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+        assert(ramp.units[b] >= 1 && ramp.units[b] <= 12);
+        if (b > 0) {
+            assert(ramp.units[b] >= ramp.units[b - 1]);
+        }
+    }
+
+    // Negative counts get the minimum, TC +3 gets 1000 * 0.005 / 1.3 ~ 3.8 -> 3 units
+    assert(ramp.units[count_bucket_for_true_count(-3)] == 1);
+    assert(ramp.units[count_bucket_for_true_count(3)] == 3);
+    assert(ramp.units[COUNT_NUM_BUCKETS - 1] == 12);
+}
+
+TEST(risk_of_ruin_constrained_ramp) {
+    CountTable table;
+    fill_synthetic_table(&table);
+
+    BetRampSolverConfig solver = {
+        .bankroll = 2000, .min_bet = 1, .max_bet = 20, .bet_increment = 0,
+        .kelly_fraction = 1.0, .max_risk_of_ruin = 0.19
+    };
+
+    BetRamp kelly;
+    BetRampSolverConfig unconstrained = solver;
+    unconstrained.max_risk_of_ruin = 0;
+    bet_ramp_solve(&table, &unconstrained, &kelly);
+
+    BetRampStats kelly_stats;
+    bet_ramp_evaluate(&kelly, &table, solver.bankroll, &kelly_stats);
+    assert(kelly_stats.risk_of_ruin > 0.19);  // Full Kelly at this spread is too risky
+
+    BetRamp ramp;
+    bool feasible = bet_ramp_solve(&table, &solver, &ramp);
+    assert(feasible);
+
+    BetRampStats stats;
+    bet_ramp_evaluate(&ramp, &table, solver.bankroll, &stats);
+    printf("\n  RoR-constrained ramp: win %.4f, SD %.3f, RoR %.3f, SCORE %.1f",
+           stats.win_rate, stats.std_dev, stats.risk_of_ruin, stats.score);
+
+    assert(stats.risk_of_ruin <= 0.19 + 1e-9);
+    assert(stats.win_rate > 0);
+    for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+        assert(ramp.units[b] <= kelly.units[b] + 1e-9);
+    }
+
+    // Flat-betting the negative counts makes 5% unreachable with this bankroll
+    solver.max_risk_of_ruin = 0.05;
+    assert(!bet_ramp_solve(&table, &solver, &ramp));
+}
+
+TEST(flat_ramp_stats_match_table) {
+    CountTable table;
+    fill_synthetic_table(&table);
+
+    BetRamp flat;
+    bet_ramp_flat(&flat, 2.0);
+
+    BetRampStats stats;
+    bet_ramp_evaluate(&flat, &table, 1000, &stats);
+    assert(fabs(stats.average_bet - 2.0) < 1e-9);
+
+    BetRamp unit;
+    bet_ramp_flat(&unit, 1.0);
+    BetRampStats unit_stats;
+    bet_ramp_evaluate(&unit, &table, 1000, &unit_stats);
+
+    // Scaling every bet scales win rate and SD but leaves SCORE unchanged
+    assert(fabs(stats.win_rate - 2 * unit_stats.win_rate) < 1e-12);
+    assert(fabs(stats.std_dev - 2 * unit_stats.std_dev) < 1e-9);
+}
+
+TEST(solved_ramp_verified_by_simulation) {
+    printf("\n  Testing: Solve a Hi-Lo ramp and verify it through simulation_run");
+
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+
+    SimulationConfig config = {0};
+    rules_init(&config.rules);
+    basic_strategy_init(&config.strategy);
+    config.num_hands = 20000;
+    config.bet_per_hand = 1.0;
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+
+    SimulationResults recorded = {0};
+    simulation_run(&config, &recorded);
+
+    long recorded_rounds = 0;
+    for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+        recorded_rounds += recorded.count_tables[0].buckets[b].rounds;
+    }
+    assert(recorded_rounds == 20000);
+
+    BetRampSolverConfig solver = {
+        .bankroll = 1000, .min_bet = 1, .max_bet = 8, .bet_increment = 1,
+        .kelly_fraction = 0.5, .max_risk_of_ruin = 0
+    };
+    BetRamp ramp;
+    bet_ramp_solve(&recorded.count_tables[0], &solver, &ramp);
+
+    BetRampVerification verification;
+    simulation_verify_bet_ramp(&config, &ramp, &recorded.count_tables[0], solver.bankroll, &verification);
+
+    printf("\n    Predicted win %.4f (SD %.3f), observed win %.4f (SD %.3f), SE %.4f",
+           verification.predicted.win_rate, verification.predicted.std_dev,
+           verification.observed.win_rate, verification.observed.std_dev,
+           verification.win_rate_std_error);
+
+    assert(verification.observed_rounds == 20000);
+    assert(fabs(verification.observed.win_rate - verification.predicted.win_rate) < 5 * verification.win_rate_std_error);
+    assert(verification.observed.average_bet >= 1.0);
+}
+
+TEST(one_pass_matches_single_system_runs) {
+    printf("\n  Testing: Several systems in one simulation match separate runs");
+
+    CountSystem systems[3];
+    count_system_builtin(0, &systems[0]);  // Hi-Lo
+    count_system_builtin(2, &systems[1]);  // Hi-Opt II
+    count_system_builtin(4, &systems[2]);  // Omega II
+
+    SimulationConfig config = {0};
+    rules_init(&config.rules);
+    basic_strategy_init(&config.strategy);
+    config.num_hands = 5000;
+    config.bet_per_hand = 1.0;
+    config.count_systems = systems;
+    config.num_count_systems = 3;
+
+    deck_set_rng_seed(424242);
+    SimulationResults shared = {0};
+    simulation_run(&config, &shared);
+
+    for (int i = 0; i < 3; i++) {
+        SimulationConfig single = config;
+        single.count_systems = &systems[i];
+        single.num_count_systems = 1;
+
+        deck_set_rng_seed(424242);
+        SimulationResults alone = {0};
+        simulation_run(&single, &alone);
+
+        for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+            assert(alone.count_tables[0].buckets[b].rounds == shared.count_tables[i].buckets[b].rounds);
+            assert(alone.count_tables[0].buckets[b].total_result == shared.count_tables[i].buckets[b].total_result);
+        }
+    }
+
+    BetRampSolverConfig spread = {
+        .bankroll = 10000, .min_bet = 1, .max_bet = 12, .bet_increment = 1,
+        .kelly_fraction = 1.0, .max_risk_of_ruin = 0
+    };
+    printf("\n");
+    simulation_print_count_report(stdout, &config, &shared, &spread);
+
+    deck_set_rng_seed(123456789);
+}
+
+TEST(seeded_simulation_ignores_history) {
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+
+    SimulationConfig config = {0};
+    rules_init(&config.rules);
+    basic_strategy_init(&config.strategy);
+    config.num_hands = 5000;
+    config.bet_per_hand = 1.0;
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+    config.seed = 99;
+    config.first_shoe = 5;
+
+    SimulationResults first = {0};
+    simulation_run(&config, &first);
+
+    // Unrelated draws in between don't change the seeded shoes
+    SimulationConfig unseeded = config;
+    unseeded.seed = 0;
+    SimulationResults other = {0};
+    simulation_run(&unseeded, &other);
+
+    SimulationResults second = {0};
+    simulation_run(&config, &second);
+    assert(second.total_payout == first.total_payout);
+    for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+        assert(second.count_tables[0].buckets[b].rounds == first.count_tables[0].buckets[b].rounds);
+    }
+
+    // Starting one shoe later replays all but the first shoe; a disjoint
+    // range deals different rounds
+    config.first_shoe = 1000;
+    SimulationResults shifted = {0};
+    simulation_run(&config, &shifted);
+    assert(shifted.total_payout != first.total_payout);
+}
+
+TEST(wonging_plays_only_inside_the_window) {
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+
+    SimulationConfig config = {0};
+    rules_init(&config.rules);
+    basic_strategy_init(&config.strategy);
+    config.num_hands = 50000;
+    config.bet_per_hand = 1.0;
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+    config.wonging = true;
+    config.wong_in = 1.0;
+    config.wong_out = 0.0;
+
+    SimulationResults results = {0};
+    simulation_run(&config, &results);
+
+    // Most of a back-counted shoe is watched, not played
+    assert(results.hands_played + results.rounds_sat_out == config.num_hands);
+    assert(results.rounds_sat_out > results.hands_played);
+    assert(results.hands_played > 0);
+
+    // Every round played started at or above the exit count
+    long recorded = 0;
+    for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+        if (b < count_bucket_for_true_count(config.wong_out)) {
+            assert(results.count_tables[0].buckets[b].rounds == 0);
+        }
+        recorded += results.count_tables[0].buckets[b].rounds;
+    }
+    assert(recorded == results.hands_played);
+}
+
+// ============================================================================
+// EFFECT OF REMOVAL TESTS
+// ============================================================================
+
+static EorTable eor_table;
+
+TEST(eor_base_ev_follows_rules) {
+    Rules rules;
+    rules_init(&rules);
+    BasicStrategy strategy;
+    basic_strategy_init(&strategy);
+
+    double composition[COUNT_NUM_RANKS];
+    eor_shoe_composition(rules.num_decks, composition);
+    double s17 = eor_strategy_ev(&rules, &strategy, composition);
+
+    rules.dealer_hits_soft_17 = true;
+    double h17 = eor_strategy_ev(&rules, &strategy, composition);
+
+    rules.dealer_hits_soft_17 = false;
+    rules.blackjack_payout = 1.2;
+    double six_to_five = eor_strategy_ev(&rules, &strategy, composition);
+
+    // Six-deck S17 DAS LS sits around -0.4% to -0.6%; H17 costs about 0.2%
+    // and 6:5 blackjack about 1.4%
+    assert(s17 < -0.002 && s17 > -0.008);
+    assert(s17 - h17 > 0.001 && s17 - h17 < 0.003);
+    assert(s17 - six_to_five > 0.01 && s17 - six_to_five < 0.02);
+}
+
+TEST(eor_signs_and_balance) {
+    Rules rules;
+    rules_init(&rules);
+    BasicStrategy strategy;
+    basic_strategy_init(&strategy);
+    eor_compute(&rules, &strategy, &eor_table);
+
+    // Small cards help the player leave, aces and tens hurt, five matters most
+    for (int r = 1; r <= 5; r++) {
+        assert(eor_table.eor[r] > 0);
+        assert(eor_table.eor[r] <= eor_table.eor[4]);
+    }
+    assert(eor_table.eor[0] < 0);
+    assert(eor_table.eor[9] < 0);
+
+    // Removing a card from a shoe and then averaging over every card leaves
+    // the shoe as it was, so the weighted effects sum to roughly zero
+    double weighted = 0.0;
+    for (int r = 0; r < COUNT_NUM_RANKS; r++) {
+        weighted += eor_table.rank_weights[r] * eor_table.eor[r];
+    }
+    assert(fabs(weighted) < 0.0001);
+
+    // Insurance only cares about tens
+    assert(eor_table.insurance_eor[9] < 0);
+    for (int r = 0; r < 9; r++) {
+        assert(eor_table.insurance_eor[r] > 0);
+        assert(fabs(eor_table.insurance_eor[r] - eor_table.insurance_eor[0]) < 1e-12);
+    }
+    assert(eor_table.num_decisions > 0 && eor_table.num_decisions <= EOR_MAX_DECISIONS);
+}
+
+TEST(eor_system_efficiencies) {
+    // Uses the table from eor_signs_and_balance
+    CountSystem hi_lo, hi_opt_1, hi_opt_2;
+    count_system_hi_lo(&hi_lo);
+    assert(count_system_by_name("Hi-Opt I", &hi_opt_1));
+    assert(count_system_by_name("Hi-Opt II", &hi_opt_2));
+
+    CountSystemEfficiency hi_lo_eff, hi_opt_1_eff, hi_opt_2_eff;
+    eor_evaluate_system(&eor_table, &hi_lo, &hi_lo_eff);
+    eor_evaluate_system(&eor_table, &hi_opt_1, &hi_opt_1_eff);
+    eor_evaluate_system(&eor_table, &hi_opt_2, &hi_opt_2_eff);
+
+    // Published figures: Hi-Lo BC .97 / PE .51 / IC .76, Hi-Opt I IC .85
+    assert(fabs(hi_lo_eff.betting_correlation - 0.97) < 0.02);
+    assert(fabs(hi_lo_eff.insurance_correlation - 0.76) < 0.02);
+    assert(fabs(hi_opt_1_eff.insurance_correlation - 0.85) < 0.02);
+
+    // Ace-neutral counts trade betting correlation for playing efficiency
+    assert(hi_lo_eff.betting_correlation > hi_opt_1_eff.betting_correlation);
+    assert(hi_lo_eff.playing_efficiency < hi_opt_1_eff.playing_efficiency);
+    assert(hi_opt_2_eff.playing_efficiency > hi_lo_eff.playing_efficiency);
+    assert(hi_lo_eff.playing_efficiency > 0.45 && hi_lo_eff.playing_efficiency < 0.6);
+
+    // A count that tracks nothing captures nothing
+    CountSystem blank = { "blank", { 0 } };
+    CountSystemEfficiency blank_eff;
+    eor_evaluate_system(&eor_table, &blank, &blank_eff);
+    assert(blank_eff.betting_correlation == 0.0);
+    assert(blank_eff.playing_efficiency == 0.0);
+}
+
+// ============================================================================
+// BENCHMARK TESTS
+// ============================================================================
+
+static BenchmarkResults single_thread_results;
+static BenchmarkResults multi_thread_results;
+
+TEST(benchmark_independent_of_thread_count) {
+    BenchmarkConfig config;
+    benchmark_config_standard(&config);
+    config.num_systems = 2;
+    config.num_spreads = 1;
+    config.num_penetrations = 2;
+    config.rounds_per_penetration = 20001;
+    config.num_batches = 6;
+
+    config.num_threads = 1;
+    assert(benchmark_run(&config, &single_thread_results));
+    config.num_threads = 4;
+    assert(benchmark_run(&config, &multi_thread_results));
+
+    for (int p = 0; p < config.num_penetrations; p++) {
+        assert(single_thread_results.rounds[p] == config.rounds_per_penetration);
+        assert(multi_thread_results.rounds[p] == config.rounds_per_penetration);
+
+        for (int c = 0; c < config.num_systems; c++) {
+            const BenchmarkCell* single = &single_thread_results.cells[p][0][c];
+            const BenchmarkCell* multi = &multi_thread_results.cells[p][0][c];
+            assert(single->win_rate.mean == multi->win_rate.mean);
+            assert(single->win_rate.lower == multi->win_rate.lower);
+            assert(single->std_dev.mean == multi->std_dev.mean);
+            assert(single->win_rate.lower <= single->win_rate.mean);
+            assert(single->win_rate.mean <= single->win_rate.upper);
+            assert(single->score.lower <= single->score.upper);
+        }
+    }
+
+    // A different seed schedule deals different shoes
+    config.seed++;
+    benchmark_run(&config, &multi_thread_results);
+    assert(single_thread_results.cells[0][0][0].win_rate.mean != multi_thread_results.cells[0][0][0].win_rate.mean);
+
+    // More batches than the per-cell buffers hold is refused, not run
+    config.num_batches = BENCHMARK_MAX_BATCHES + 1;
+    config.rounds_per_penetration = 100000;
+    assert(!benchmark_config_valid(&config));
+    assert(!benchmark_run(&config, &multi_thread_results));
+}
+
+TEST(scaling_steps_double_up_to_max_threads) {
+    BenchmarkScalingConfig config;
+    benchmark_scaling_config_standard(&config);
+    config.max_threads = 3;
+    config.rounds = 6000;
+    config.num_systems = 2;
+    count_system_builtin(0, &config.systems[0]);
+    count_system_builtin(1, &config.systems[1]);
+    config.pinning = POOL_PIN_CORES;
+
+    BenchmarkScalingResults results;
+    assert(benchmark_scaling_run(&config, &results));
+    assert(results.num_steps == 3);
+    assert(results.num_nodes >= 1);
+    int expected_threads[] = { 1, 2, 3 };
+    for (int i = 0; i < results.num_steps; i++) {
+        const BenchmarkScalingStep* step = &results.steps[i];
+        assert(step->threads == expected_threads[i]);
+        assert(step->rounds == 6000);
+        assert(step->ev == results.steps[0].ev);  // Same tasks at every thread count
+        assert(step->hands_per_second > 0);
+        assert(fabs(step->efficiency * step->threads - step->speedup) < 1e-9);
+    }
+    assert(results.steps[0].speedup == 1.0);
+
+    // Weak scaling grows the job with the threads
+    config.weak = true;
+    config.num_systems = 0;
+    config.max_threads = 2;
+    config.pinning = POOL_PIN_NODES;
+    assert(benchmark_scaling_run(&config, &results));
+    assert(results.num_steps == 2);
+    assert(results.steps[0].rounds == 6000);
+    assert(results.steps[1].rounds == 12000);
+}
+
+int main(void) {
+    printf("Running Counting & Betting Tests\n");
+    printf("==================================\n\n");
+
+    // Count tracking
+    run_test_hi_lo_is_balanced();
+    run_test_tracker_true_count();
+    run_test_unbalanced_system_counts_from_its_irc();
+    run_test_multi_system_tracker_matches_scalar_counts();
+    run_test_true_count_buckets_floor();
+
+    // Bet ramp solver
+    run_test_kelly_ramp_is_monotone_and_clamped();
+    run_test_risk_of_ruin_constrained_ramp();
+    run_test_flat_ramp_stats_match_table();
+    run_test_solved_ramp_verified_by_simulation();
+
+    // Multi-system evaluation
+    run_test_one_pass_matches_single_system_runs();
+    run_test_seeded_simulation_ignores_history();
+    run_test_wonging_plays_only_inside_the_window();
+
+    // Effects of removal
+    run_test_eor_base_ev_follows_rules();
+    run_test_eor_signs_and_balance();
+    run_test_eor_system_efficiencies();
+
+    // Benchmark harness
+    run_test_benchmark_independent_of_thread_count();
+    run_test_scaling_steps_double_up_to_max_threads();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <math.h>
 // #include "game.h"
 #include "deck.h"
+#include "cpu.h"
 
 // Simple test framework
 int tests_run = 0;
@@ -61,6 +63,396 @@ TEST(card_dealing) {
     deck_destroy(&deck);
 }
 
+// Deal the first two cards of a fresh one-deck shoe many times and check
+// every card turns up at every position about equally often
+static void check_first_cards_uniform(DeckMode mode) {
+    int counts[2][52] = {{0}};
+    int trials = 52000;
+
+    Deck deck;
+    deck_init(&deck, 1);
+    deck_set_mode(&deck, mode);
+
+    for (int t = 0; t < trials; t++) {
+        deck_shuffle(&deck);
+        counts[0][deck_deal(&deck)]++;
+        counts[1][deck_deal(&deck)]++;
+    }
+
+    // Chi-square with 51 degrees of freedom; 100 is far past the 99.99th percentile
+    double expected = trials / 52.0;
+    for (int p = 0; p < 2; p++) {
+        double chi_square = 0.0;
+        for (int card = 0; card < 52; card++) {
+            double diff = counts[p][card] - expected;
+            chi_square += diff * diff / expected;
+        }
+        assert(chi_square < 100.0);
+    }
+
+    deck_destroy(&deck);
+}
+
+TEST(full_shuffle_is_uniform) {
+    // A card can stay where it started (a shuffle that always moves every
+    // card only produces cyclic permutations)
+    Deck deck;
+    deck_init(&deck, 1);
+    int stayed = 0;
+    for (int t = 0; t < 5200; t++) {
+        for (int i = 0; i < deck.total_cards; i++) {
+            deck.cards[i] = i;
+        }
+        deck_shuffle(&deck);
+        stayed += deck.cards[0] == 0;
+    }
+    assert(stayed > 50 && stayed < 150);
+    deck_destroy(&deck);
+
+    check_first_cards_uniform(DECK_SHUFFLE_FULL);
+}
+
+TEST(lazy_shuffle_is_uniform) {
+    check_first_cards_uniform(DECK_SHUFFLE_LAZY);
+}
+
+TEST(lazy_shoe_deals_every_card_once) {
+    Deck deck;
+    deck_init(&deck, 2);
+    deck_set_mode(&deck, DECK_SHUFFLE_LAZY);
+
+    for (int shoe = 0; shoe < 3; shoe++) {
+        int counts[52] = {0};
+        deck_shuffle(&deck);
+        assert(deck.position == 0);
+
+        // Part of a shoe, then reshuffle: the next shoe is still complete
+        for (int i = 0; i < (shoe == 1 ? 40 : deck.total_cards); i++) {
+            counts[deck_deal(&deck)]++;
+        }
+        if (shoe == 1) {
+            continue;
+        }
+        for (int card = 0; card < 52; card++) {
+            assert(counts[card] == 2);
+        }
+    }
+
+    deck_destroy(&deck);
+}
+
+TEST(composition_shoe_deals_every_rank) {
+    Deck deck;
+    deck_init_mode(&deck, 6, DECK_COMPOSITION);
+    assert(deck.cards == NULL);
+
+    int composition[DECK_NUM_RANKS];
+    deck_composition(&deck, composition);
+    assert(composition[0] == 24 && composition[4] == 24 && composition[9] == 96);
+
+    int counts[DECK_NUM_RANKS] = {0};
+    for (int i = 0; i < deck.total_cards; i++) {
+        int card = deck_deal(&deck);
+        assert(card >= 0 && card < DECK_NUM_RANKS);
+        counts[card]++;
+
+        // The composition always matches what's left
+        if (i == 100) {
+            deck_composition(&deck, composition);
+            for (int r = 0; r < DECK_NUM_RANKS; r++) {
+                assert(composition[r] == (r == 9 ? 96 : 24) - counts[r]);
+            }
+        }
+    }
+
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        assert(counts[r] == (r == 9 ? 96 : 24));
+    }
+
+    // Shuffling refills the counts
+    deck_shuffle(&deck);
+    deck_composition(&deck, composition);
+    assert(deck.position == 0 && composition[9] == 96);
+
+    deck_destroy(&deck);
+}
+
+TEST(composition_shoe_matches_card_shoe) {
+    // First and second card ranks from a one-deck shoe, composition vs array
+    int trials = 52000;
+    int counts[2][DECK_NUM_RANKS] = {{0}};
+    int second_given_ten[2] = {0};
+    int tens_first[2] = {0};
+    DeckMode modes[2] = { DECK_COMPOSITION, DECK_SHUFFLE_LAZY };
+
+    for (int m = 0; m < 2; m++) {
+        Deck deck;
+        deck_init_mode(&deck, 1, modes[m]);
+        for (int t = 0; t < trials; t++) {
+            deck_shuffle(&deck);
+            int first = deck_deal(&deck) % 13;
+            int second = deck_deal(&deck) % 13;
+            first = first < 9 ? first : 9;
+            second = second < 9 ? second : 9;
+            counts[m][first]++;
+            if (first == 9) {
+                tens_first[m]++;
+                second_given_ten[m] += second == 9;
+            }
+        }
+        deck_destroy(&deck);
+    }
+
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        double expected = trials * (r == 9 ? 16.0 : 4.0) / 52.0;
+        assert(fabs(counts[0][r] - expected) < 5 * sqrt(expected));
+    }
+
+    // Dealing a ten depletes the tens: 15/51 for the next card
+    for (int m = 0; m < 2; m++) {
+        double rate = (double)second_given_ten[m] / tens_first[m];
+        assert(fabs(rate - 15.0 / 51.0) < 0.02);
+    }
+}
+
+TEST(infinite_shoe_never_depletes) {
+    Deck deck;
+    deck_init_mode(&deck, 1, DECK_INFINITE);
+    assert(deck.cards == NULL);
+
+    // 130k i.i.d. draws: 1/13 per rank, 4/13 tens, and a ten is just as
+    // likely right after a ten
+    int trials = 130000;
+    int counts[DECK_NUM_RANKS] = {0};
+    int tens_after_ten = 0;
+    int tens = 0;
+    int previous = -1;
+    for (int t = 0; t < trials; t++) {
+        int rank = deck_deal(&deck);
+        assert(rank >= 0 && rank < DECK_NUM_RANKS);
+        counts[rank]++;
+        if (previous == 9) {
+            tens++;
+            tens_after_ten += rank == 9;
+        }
+        previous = rank;
+    }
+    assert(deck.position == 0);
+
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        double expected = trials * (r == 9 ? 4.0 : 1.0) / 13.0;
+        assert(fabs(counts[r] - expected) < 5 * sqrt(expected));
+    }
+    assert(fabs((double)tens_after_ten / tens - 4.0 / 13.0) < 0.01);
+
+    int composition[DECK_NUM_RANKS];
+    deck_composition(&deck, composition);
+    assert(composition[0] == 1 && composition[9] == 4);
+
+    deck_destroy(&deck);
+}
+
+TEST(infinite_shoe_follows_rank_weights) {
+    Deck deck;
+    deck_init_mode(&deck, 6, DECK_INFINITE);
+
+    // Only tens
+    int tens_only[DECK_NUM_RANKS] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+    assert(deck_set_rank_weights(&deck, tens_only));
+    for (int t = 0; t < 1000; t++) {
+        assert(deck_deal(&deck) == 9);
+    }
+
+    // A lopsided composition: weights 1..10
+    int weights[DECK_NUM_RANKS] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    assert(deck_set_rank_weights(&deck, weights));
+    int trials = 110000;
+    int counts[DECK_NUM_RANKS] = {0};
+    for (int t = 0; t < trials; t++) {
+        counts[deck_deal(&deck)]++;
+    }
+    for (int r = 0; r < DECK_NUM_RANKS; r++) {
+        double expected = trials * weights[r] / 55.0;
+        assert(fabs(counts[r] - expected) < 5 * sqrt(expected));
+    }
+
+    // Weights whose draw range wouldn't fit an int are refused and change nothing
+    int huge[DECK_NUM_RANKS] = { INT_MAX / 2, INT_MAX / 2, 0, 0, 0, 0, 0, 0, 0, 0 };
+    int negative[DECK_NUM_RANKS] = { -1, 0, 0, 0, 0, 0, 0, 0, 0, 2 };
+    int none[DECK_NUM_RANKS] = {0};
+    int at_limit[DECK_NUM_RANKS] = { DECK_MAX_RANK_WEIGHT_TOTAL, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    assert(!deck_set_rank_weights(&deck, huge));
+    assert(!deck_set_rank_weights(&deck, negative));
+    assert(!deck_set_rank_weights(&deck, none));
+    assert(deck.rank_weights[9] == 10);
+    assert(deck_set_rank_weights(&deck, at_limit));
+    for (int t = 0; t < 100; t++) {
+        assert(deck_deal(&deck) == 0);
+    }
+
+    // Switching to a card shoe and back allocates and frees the cards
+    deck_set_mode(&deck, DECK_SHUFFLE_LAZY);
+    assert(deck.cards != NULL);
+    deck_set_mode(&deck, DECK_INFINITE);
+    assert(deck.cards == NULL);
+
+    deck_destroy(&deck);
+}
+
+TEST(philox_known_answers) {
+    // Random123's Philox4x32-10 known-answer vectors
+    uint32_t output[RNG_BLOCK_WORDS];
+    uint32_t zero_counter[RNG_BLOCK_WORDS] = { 0, 0, 0, 0 };
+    uint32_t zero_key[2] = { 0, 0 };
+    rng_philox(zero_counter, zero_key, output);
+    assert(output[0] == 0x6627e8d5 && output[1] == 0xe169c58d && output[2] == 0xbc57ac4c && output[3] == 0x9b00dbd8);
+
+    uint32_t pi_counter[RNG_BLOCK_WORDS] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+    uint32_t pi_key[2] = { 0xa4093822, 0x299f31d0 };
+    rng_philox(pi_counter, pi_key, output);
+    assert(output[0] == 0xd16cfe09 && output[1] == 0x94fdcceb && output[2] == 0x5001e420 && output[3] == 0x24126ea1);
+}
+
+TEST(buffered_stream_matches_philox_blocks) {
+    // Every kernel this machine runs hands out blocks 0, 1, 2, ... of
+    // (seed, stream) in order, across the small first fill and the batched
+    // refills after it
+    uint64_t seed = 0x0123456789ABCDEFull;
+    uint64_t stream = (1ull << 32) + 7;
+    uint32_t key[2] = { (uint32_t)seed, (uint32_t)(seed >> 32) };
+
+    for (int level = CPU_LEVEL_SCALAR; level <= (int)cpu_detect(); level++) {
+        cpu_set_level((CpuLevel)level);
+        assert(cpu_level() == (CpuLevel)level);
+
+        RngStream rng;
+        rng_stream_init(&rng, seed, stream);
+        for (uint32_t block = 0; block < 3 * RNG_BUFFER_BLOCKS + 5; block++) {
+            uint32_t counter[RNG_BLOCK_WORDS] = { block, 0, (uint32_t)stream, (uint32_t)(stream >> 32) };
+            uint32_t expected[RNG_BLOCK_WORDS];
+            rng_philox(counter, key, expected);
+            for (int w = 0; w < RNG_BLOCK_WORDS; w++) {
+                assert(rng_next(&rng) == expected[w]);
+            }
+        }
+    }
+
+    // Asking for more than the machine has gets what it has
+    cpu_set_level(CPU_LEVEL_AVX512);
+    assert(cpu_level() == cpu_detect());
+}
+
+TEST(bounded_draws_are_unbiased) {
+    RngStream rng;
+    rng_stream_init(&rng, 5, 0);
+
+    int trials = 70000;
+    int counts[7] = {0};
+    for (int t = 0; t < trials; t++) {
+        uint32_t value = rng_range(&rng, 7);
+        assert(value < 7);
+        counts[value]++;
+    }
+    for (int v = 0; v < 7; v++) {
+        assert(fabs(counts[v] - trials / 7.0) < 5 * sqrt(trials / 7.0));
+    }
+
+    // A range of 3 * 2^30: a plain 32-bit modulo would put half the draws in
+    // the bottom third
+    uint32_t max = 3u << 30;
+    int bottom_third = 0;
+    for (int t = 0; t < trials; t++) {
+        uint32_t value = rng_range(&rng, max);
+        assert(value < max);
+        bottom_third += value < (1u << 30);
+    }
+    assert(fabs(bottom_third - trials / 3.0) < 5 * sqrt(trials * 2.0 / 9.0));
+}
+
+TEST(shoes_depend_only_on_their_coordinates) {
+    // Deal part of shoes 0..4 of seed 77 in sequence, remembering shoe 3
+    Deck dealt;
+    deck_init_mode(&dealt, 2, DECK_SHUFFLE_LAZY);
+    deck_seed(&dealt, 77, 0);
+    int shoe_three[104];
+    for (int shoe = 0; shoe < 5; shoe++) {
+        deck_shuffle(&dealt);
+        assert(dealt.shoe_index == (uint64_t)shoe);
+        for (int i = 0; i < 30 + 10 * shoe; i++) {
+            int card = deck_deal(&dealt);
+            if (shoe == 3) {
+                shoe_three[i] = card;
+            }
+        }
+    }
+    deck_destroy(&dealt);
+
+    // A fresh deck, after unrelated draws on another seed, regenerates shoe 3
+    // from card 25 on, fully shuffled or lazily
+    DeckMode modes[2] = { DECK_SHUFFLE_LAZY, DECK_SHUFFLE_FULL };
+    for (int m = 0; m < 2; m++) {
+        Deck replayed;
+        deck_init_mode(&replayed, 2, modes[m]);
+        deck_shuffle(&replayed);
+        deck_deal(&replayed);
+
+        deck_replay(&replayed, 77, 3, 25);
+        for (int i = 25; i < 60; i++) {
+            assert(deck_deal(&replayed) == shoe_three[i]);
+        }
+
+        // The next shoe differs
+        deck_shuffle(&replayed);
+        assert(replayed.shoe_index == 4);
+        int same = 0;
+        for (int i = 0; i < 60; i++) {
+            same += deck_deal(&replayed) == shoe_three[i];
+        }
+        assert(same < 20);
+        deck_destroy(&replayed);
+    }
+}
+
+TEST(rewound_shoe_deals_the_same_cards_again) {
+    DeckMode modes[4] = { DECK_SHUFFLE_FULL, DECK_SHUFFLE_LAZY, DECK_COMPOSITION, DECK_INFINITE };
+    for (int m = 0; m < 4; m++) {
+        Deck deck;
+        deck_init_mode(&deck, 1, modes[m]);
+        deck_seed(&deck, 91, 0);
+        deck_shuffle(&deck);
+        for (int i = 0; i < 7; i++) {
+            deck_deal(&deck);
+        }
+
+        // Far enough past the mark to refill the random stream's buffer
+        DeckMark mark;
+        deck_mark(&deck, &mark);
+        int first[40];
+        for (int i = 0; i < 40; i++) {
+            first[i] = deck_deal(&deck);
+        }
+
+        for (int pass = 0; pass < 3; pass++) {
+            deck_rewind(&deck, &mark);
+            assert(deck.position == mark.position);
+            int length = pass == 1 ? 3 : 40;
+            for (int i = 0; i < length; i++) {
+                assert(deck_deal(&deck) == first[i]);
+            }
+        }
+
+        // Rewinding into a shoe that has since been reshuffled deals it again
+        deck_shuffle(&deck);
+        deck_deal(&deck);
+        deck_rewind(&deck, &mark);
+        assert(deck.shoe_index == mark.shoe_index);
+        for (int i = 0; i < 40; i++) {
+            assert(deck_deal(&deck) == first[i]);
+        }
+        deck_destroy(&deck);
+    }
+}
+
 int main(void) {
     printf("Running Blackjack Simulator Tests\n");
     printf("==================================\n\n");
@@ -69,6 +461,18 @@ int main(void) {
     run_test_deck_initialization();
     run_test_deck_shuffle();
     run_test_card_dealing();
+    run_test_full_shuffle_is_uniform();
+    run_test_lazy_shuffle_is_uniform();
+    run_test_lazy_shoe_deals_every_card_once();
+    run_test_composition_shoe_deals_every_rank();
+    run_test_composition_shoe_matches_card_shoe();
+    run_test_infinite_shoe_never_depletes();
+    run_test_infinite_shoe_follows_rank_weights();
+    run_test_philox_known_answers();
+    run_test_buffered_stream_matches_philox_blocks();
+    run_test_bounded_draws_are_unbiased();
+    run_test_shoes_depend_only_on_their_coordinates();
+    run_test_rewound_shoe_deals_the_same_cards_again();
     
     printf("\n==================================\n");
     printf("Tests passed: %d/%d\n", tests_passed, tests_run);
@@ -85,6 +85,67 @@ TEST(dealer_hits_on_soft_17_h17) {
     hand_destroy(&hand);
 }
 
+// Every hand of up to five cards, under both soft 17 rules
+TEST(dealer_table_agrees_with_dealer_should_hit) {
+    for (int h17 = 0; h17 < 2; h17++) {
+        Rules rules;
+        rules_init(&rules);
+        rules.dealer_hits_soft_17 = h17;
+        DealerTable table;
+        dealer_table_init(&table, &rules);
+
+        for (int code = 0; code < 100000; code++) {
+            Hand hand;
+            hand_init(&hand);
+            int state = 0;
+            for (int rest = code; hand.num_cards < 5; rest /= 10) {
+                hand_add_card(&hand, rest % 10);
+                state = table.next[state][rest % 10];
+
+                int value = hand_get_value(&hand);
+                assert(table.total[state] == (value > 21 ? DEALER_BUST_TOTAL : value));
+                assert(table.stands[state] == !dealer_should_hit(&hand, &rules));
+                assert(state == dealer_hand_state(&table, &hand));
+                if (table.stands[state]) {
+                    break;
+                }
+            }
+            hand_destroy(&hand);
+        }
+    }
+}
+
+TEST(dealer_plays_from_table) {
+    Rules rules;
+    rules_init(&rules);
+    rules.dealer_hits_soft_17 = true;
+    DealerTable table;
+    dealer_table_init(&table, &rules);
+
+    Deck deck;
+    deck_init(&deck, 1);
+    deck_seed(&deck, 11, 0);
+    deck_shuffle(&deck);
+    for (int round = 0; round < 1000; round++) {
+        Hand hand;
+        hand_init(&hand);
+        hand_add_card(&hand, 0);   // Ace
+        hand_add_card(&hand, 5);   // 6: soft 17 hits under H17
+
+        int total = dealer_play(&table, &hand, &deck);
+        assert(hand.num_cards > 2);
+        assert(!dealer_should_hit(&hand, &rules));
+        assert(total == (hand_get_value(&hand) > 21 ? DEALER_BUST_TOTAL : hand_get_value(&hand)));
+        hand_destroy(&hand);
+
+        if (deck.position > 40) {
+            deck_shuffle(&deck);
+        }
+    }
+
+    deck_destroy(&deck);
+}
+
 // ============================================================================
 // GAME STATE TESTS
 // ============================================================================
@@ -301,6 +362,34 @@ TEST(game_dealer_busts) {
     game_destroy(&game);
 }
 
+TEST(game_busted_hand_loses_when_dealer_busts) {
+    Rules rules;
+    rules_init(&rules);
+
+    GameState game;
+    game_init(&game, &rules, 10.0);
+    game.num_player_hands = 2;  // Two hands after a split
+    game.player_bets[1] = 10.0;
+
+    // First hand busts with 24, second stands on 18
+    hand_add_card(&game.player_hands[0], 7);   // 8
+    hand_add_card(&game.player_hands[0], 5);   // 6
+    hand_add_card(&game.player_hands[0], 9);   // 10
+    hand_add_card(&game.player_hands[1], 7);   // 8
+    hand_add_card(&game.player_hands[1], 9);   // 10
+
+    // Dealer busts with 22
+    hand_add_card(&game.dealer_hand, 9);   // 10
+    hand_add_card(&game.dealer_hand, 5);   // 6
+    hand_add_card(&game.dealer_hand, 5);   // 6 -> 22
+
+    // The bust lost before the dealer drew; only the standing hand is paid
+    double payout = game_resolve(&game);
+    assert(payout == 20.0);
+
+    game_destroy(&game);
+}
+
 TEST(game_twentyone_not_blackjack) {
     Rules rules;
     rules_init(&rules);
@@ -564,6 +653,82 @@ TEST(game_split_aces) {
     game_destroy(&game);
 }
 
+TEST(game_reset_round_keeps_shoe) {
+    Rules rules;
+    rules_init(&rules);
+
+    GameState game;
+    game_init(&game, &rules, 10.0);
+    game_deal_initial(&game);
+    game_play_action(&game, DOUBLE, 0);
+    game_take_insurance(&game, 5.0);
+    game_resolve(&game);
+
+    int shoe_position = game.deck.position;
+    game_reset_round(&game, 25.0);
+
+    // Round state is cleared but the shoe carries on where it left off
+    assert(game.num_player_hands == 0);
+    assert(game.player_hands[0].num_cards == 0);
+    assert(game.dealer_hand.num_cards == 0);
+    assert(game.player_bets[0] == 25.0);
+    assert(game.insurance_bet == 0);
+    assert(game.game_over == false);
+    assert(game.deck.position == shoe_position);
+
+    game_deal_initial(&game);
+    assert(game.player_hands[0].num_cards == 2);
+    assert(game.deck.position == shoe_position + 4);
+
+    game_destroy(&game);
+}
+
+TEST(game_snapshot_restores_round_and_shoe) {
+    Rules rules;
+    rules_init(&rules);
+
+    GameState game;
+    game_init(&game, &rules, 10.0);
+    deck_set_mode(&game.deck, DECK_SHUFFLE_LAZY);
+    deck_shuffle(&game.deck);
+    game_deal_initial(&game);
+    game_take_insurance(&game, 5.0);
+
+    GameSnapshot snapshot;
+    game_snapshot_init(&snapshot, &rules);
+    game_snapshot_save(&snapshot, &game);
+    int player_cards[2] = { game.player_hands[0].cards[0], game.player_hands[0].cards[1] };
+
+    // Play the round out a different way each time; the cards that come are the same
+    int next_card = -1;
+    PlayerAction actions[3] = { HIT, DOUBLE, SPLIT };
+    for (int a = 0; a < 3; a++) {
+        game_play_action(&game, actions[a], 0);
+        game_play_action(&game, HIT, 0);
+        game_resolve(&game);
+        game_snapshot_restore(&snapshot, &game);
+
+        assert(game.num_player_hands == 1);
+        assert(game.player_hands[0].num_cards == 2);
+        assert(game.player_hands[0].cards[0] == player_cards[0]);
+        assert(game.player_hands[0].cards[1] == player_cards[1]);
+        assert(game.player_hands[1].num_cards == 0);
+        assert(game.player_bets[0] == 10.0);
+        assert(game.insurance_bet == 5.0);
+        assert(game.dealer_hand.num_cards == 2);
+        assert(game.game_over == false);
+        assert(game.deck.position == 4);
+
+        int card = deck_deal(game.shoe);
+        assert(next_card < 0 || card == next_card);
+        next_card = card;
+        game_snapshot_restore(&snapshot, &game);
+    }
+
+    game_snapshot_destroy(&snapshot);
+    game_destroy(&game);
+}
+
 int main(void) {
     printf("Running Game Logic Tests\n");
     printf("==================================\n\n");
@@ -575,6 +740,8 @@ int main(void) {
     run_test_dealer_stands_on_17();
     run_test_dealer_stands_on_soft_17_standard();
     run_test_dealer_hits_on_soft_17_h17();
+    run_test_dealer_table_agrees_with_dealer_should_hit();
+    run_test_dealer_plays_from_table();
 
     // Game state tests
     run_test_game_initialization();
@@ -586,6 +753,7 @@ int main(void) {
     run_test_game_player_wins();
     run_test_game_push();
     run_test_game_dealer_busts();
+    run_test_game_busted_hand_loses_when_dealer_busts();
     run_test_game_twentyone_not_blackjack();
 
     // Double down tests
@@ -601,6 +769,10 @@ int main(void) {
     run_test_game_player_splits_pair();
     run_test_game_split_aces();
 
+    // Multi-round tests
+    run_test_game_reset_round_keeps_shoe();
+    run_test_game_snapshot_restores_round_and_shoe();
+
     printf("\n==================================\n");
     printf("Tests passed: %d/%d\n", tests_passed, tests_run);
 
@@ -216,6 +216,20 @@ TEST(hand_multiple_aces) {
     hand_destroy(&hand);
 }
 
+TEST(hand_multiple_aces_count_hard) {
+    Hand hand;
+    hand_init(&hand);
+
+    // A + A + T = 12: only one ace can ever count as 11, and here neither can
+    hand_add_card(&hand, 0);  // Ace
+    hand_add_card(&hand, 0);  // Ace
+    hand_add_card(&hand, 9);  // 10
+    assert(hand_get_value(&hand) == 12);
+    assert(hand_is_soft(&hand) == false);
+
+    hand_destroy(&hand);
+}
+
 TEST(hand_bust_with_aces) {
     Hand hand;
     hand_init(&hand);
@@ -372,6 +386,7 @@ int main(void) {
     run_test_hand_soft_values();
     run_test_hand_soft_becomes_hard();
     run_test_hand_multiple_aces();
+    run_test_hand_multiple_aces_count_hard();
     run_test_hand_bust_with_aces();
     run_test_hand_blackjack_detection();
     run_test_hand_split_detection();
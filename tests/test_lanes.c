@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/lanes.h"
+#include "../src/deck.h"
+#include "simulation_fixtures.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+static void run_both(SimulationConfig* config, SimulationResults* lanes, SimulationResults* scalar) {
+    SimulationResults blank = {0};
+    *lanes = blank;
+    *scalar = blank;
+    lanes_run(config, lanes);
+    simulation_run(config, scalar);
+}
+
+// ============================================================================
+// LANE ENGINE TESTS
+// ============================================================================
+
+TEST(compiled_strategy_matches_basic_strategy) {
+    Rules rules;
+    BasicStrategy strategy;
+    rules_init(&rules);
+    basic_strategy_init(&strategy);
+
+    LaneStrategy lane_strategy;
+    lanes_compile_strategy(&lane_strategy, &rules, &strategy);
+
+    // Upcards are rank indices: 0 is an ace, 5 a six, 9 a ten
+    assert(lane_strategy.first[7 * 10 + 7][9] == SPLIT);    // 8,8 v T
+    assert(lane_strategy.first[8 * 10 + 1][5] == DOUBLE);   // 9,2 v 6
+    assert(lane_strategy.first[9 * 10 + 9][5] == STAND);    // T,T v 6
+    assert(lane_strategy.later[16][9] == HIT);              // Hard 16 v T, no surrender left
+    assert(lane_strategy.later[12][5] == STAND);            // Hard 12 v 6
+    assert(lane_strategy.later[22 + 18][9] == HIT);         // Soft 18 v T
+    assert(lane_strategy.later[22 + 19][5] == STAND);       // Soft 19 v 6 can't double any more
+}
+
+TEST(lanes_match_scalar_engine) {
+    SimulationConfig config;
+    SimulationResults lanes, scalar;
+
+    // Not a multiple of the lane width, so the last block runs part empty
+    simulation_config_init(&config, 100003, 12345, 7);
+    run_both(&config, &lanes, &scalar);
+
+    assert(lanes.hands_played == 100003);
+    assert(lanes.splits_taken > 0 && lanes.doubles_taken > 0);
+    assert_same_results(&lanes, &scalar);
+}
+
+TEST(lanes_match_scalar_engine_under_other_rules) {
+    SimulationConfig config;
+    SimulationResults lanes, scalar;
+
+    simulation_config_init(&config, 50000, 99, 7);
+    config.rules.dealer_hits_soft_17 = !config.rules.dealer_hits_soft_17;
+    config.rules.dealer_peeks_blackjack = !config.rules.dealer_peeks_blackjack;
+    config.rules.late_surrender_allowed = true;
+    config.rules.blackjack_payout = 1.2;
+    config.rules.max_splits = 0;
+    run_both(&config, &lanes, &scalar);
+
+    assert(lanes.splits_taken == 0);
+    assert_same_results(&lanes, &scalar);
+}
+
+// Every combination of the rules the kernels specialize on, so each kernel
+// and the generic fallback play against the scalar engine
+TEST(every_rule_kernel_matches_scalar_engine) {
+    SimulationConfig config;
+    SimulationResults lanes, scalar;
+
+    for (int combination = 0; combination < 8; combination++) {
+        simulation_config_init(&config, 20000, 31 + combination, 7);
+        config.rules.dealer_peeks_blackjack = combination & 1;
+        config.rules.late_surrender_allowed = combination & 2;
+        config.rules.max_splits = combination & 4 ? 3 : 0;
+        run_both(&config, &lanes, &scalar);
+        assert_same_results(&lanes, &scalar);
+    }
+}
+
+TEST(lanes_match_scalar_engine_without_cards) {
+    SimulationConfig config;
+    SimulationResults lanes, scalar;
+    DeckMode modes[2] = { DECK_COMPOSITION, DECK_INFINITE };
+
+    for (int m = 0; m < 2; m++) {
+        simulation_config_init(&config, 30000, 2024, 7);
+        config.deck_mode = modes[m];
+        run_both(&config, &lanes, &scalar);
+        assert_same_results(&lanes, &scalar);
+    }
+}
+
+// A context carried from run to run, through changes of deck count, split
+// limit and deck mode, plays exactly what fresh runs play
+TEST(reused_context_matches_fresh_runs) {
+    SimulationConfig configs[4];
+    simulation_config_init(&configs[0], 20000, 5, 7);
+    simulation_config_init(&configs[1], 20000, 6, 7);
+    configs[1].rules.num_decks = 1;
+    simulation_config_init(&configs[2], 20000, 7, 7);
+    configs[2].rules.max_splits = 0;
+    configs[2].deck_mode = DECK_COMPOSITION;
+    simulation_config_init(&configs[3], 20000, 8, 7);
+
+    SimulationContext context;
+    simulation_context_init(&context);
+    for (int c = 0; c < 4; c++) {
+        SimulationResults reused = {0}, fresh = {0};
+        lanes_run_in(&context, &configs[c], &reused);
+        lanes_run(&configs[c], &fresh);
+        assert_same_results(&reused, &fresh);
+
+        SimulationResults scalar_reused = {0};
+        simulation_run_in(&context, &configs[c], &scalar_reused);
+        assert_same_results(&scalar_reused, &fresh);
+    }
+    simulation_context_destroy(&context);
+}
+
+TEST(unseeded_lanes_have_scalar_edge) {
+    SimulationConfig config;
+    SimulationResults lanes = {0};
+    simulation_config_init(&config, 400000, 0, 7);
+    lanes_run(&config, &lanes);
+
+    // Same game as the seeded runs above, just from the thread's default shoes
+    assert(lanes.hands_played == 400000);
+    assert(fabs(simulation_get_ev(&lanes)) < 0.02);
+}
+
+int main(void) {
+    printf("Running Lane Engine Tests\n");
+    printf("==================================\n\n");
+
+    run_test_compiled_strategy_matches_basic_strategy();
+    run_test_lanes_match_scalar_engine();
+    run_test_lanes_match_scalar_engine_under_other_rules();
+    run_test_every_rule_kernel_matches_scalar_engine();
+    run_test_lanes_match_scalar_engine_without_cards();
+    run_test_reused_context_matches_fresh_runs();
+    run_test_unseeded_lanes_have_scalar_edge();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
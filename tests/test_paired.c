@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/paired.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+// A run of one side alone, on the same shoes the paired run deals
+static double run_alone(const Rules* rules, const BasicStrategy* strategy, int num_hands, uint64_t seed) {
+    SimulationConfig config = {0};
+    config.rules = *rules;
+    config.strategy = *strategy;
+    config.num_hands = num_hands;
+    config.bet_per_hand = 1.0;
+    config.seed = seed;
+    SimulationResults results = {0};
+    simulation_run(&config, &results);
+    return results.total_result;
+}
+
+static void pair_with(Rules* a, Rules* b, int which) {
+    rules_init(a);
+    *b = *a;
+    switch (which) {
+        case 0:
+            b->dealer_hits_soft_17 = true;
+            break;
+        case 1:
+            b->double_after_split = false;
+            break;
+        case 2:
+            b->late_surrender_allowed = false;
+            break;
+        default:
+            b->num_decks = 2;
+            a->num_decks = 2;
+            b->max_splits = 1;
+            a->max_splits = 1;
+            b->can_resplit_aces = true;
+            b->dealer_hits_soft_17 = true;
+            b->blackjack_payout = 1.2;
+            break;
+    }
+}
+
+// ============================================================================
+// PAIRED TESTS
+// ============================================================================
+
+// Each side of a paired run plays every round exactly as a run of its own
+// rules would, forks and all
+TEST(each_side_matches_its_own_run) {
+    for (int which = 0; which < 4; which++) {
+        Rules a, b;
+        pair_with(&a, &b, which);
+        PairedConfig paired;
+        paired_config_init(&paired, &a, &b, 40000, 4900 + which);
+
+        PairedResults results = {0};
+        assert(paired_run(&paired, &results));
+        assert(results.rounds == 40000);
+        assert(results.diverged > 0);
+        assert(results.total_a == run_alone(&a, &paired.config.strategy, 40000, 4900 + which));
+        assert(results.total_b == run_alone(&b, &paired.strategy_b, 40000, 4900 + which));
+    }
+}
+
+TEST(same_rules_never_diverge) {
+    Rules a, b;
+    rules_init(&a);
+    b = a;
+    PairedConfig paired;
+    paired_config_init(&paired, &a, &b, 20000, 17);
+
+    PairedResults results = {0};
+    assert(paired_run(&paired, &results));
+    assert(results.diverged == 0);
+    assert(results.total_a == results.total_b);
+    assert(paired_get_difference(&results) == 0.0);
+    assert(paired_get_difference_standard_error(&results) == 0.0);
+}
+
+// H17 touches a few rounds in a hundred and costs about 0.2%; paired, its
+// standard error is a small fraction of what two separate runs would give
+TEST(h17_difference_is_measured_on_the_rounds_it_changes) {
+    Rules a, b;
+    pair_with(&a, &b, 0);
+    PairedConfig paired;
+    paired_config_init(&paired, &a, &b, 200000, 23);
+
+    PairedResults results = {0};
+    assert(paired_run(&paired, &results));
+    double diverged = (double)results.diverged / results.rounds;
+    assert(diverged > 0.01 && diverged < 0.15);
+
+    double difference = paired_get_difference(&results);
+    double paired_error = paired_get_difference_standard_error(&results);
+    assert(fabs(difference + 0.002) < 4 * paired_error + 0.0005);
+    assert(paired_error < paired_get_independent_standard_error(&results) / 4);
+    assert(fabs(paired_get_ev_b(&results) - paired_get_ev_a(&results) - difference) < 1e-12);
+}
+
+TEST(halves_add_up_to_the_whole) {
+    Rules a, b;
+    pair_with(&a, &b, 2);
+    PairedConfig paired;
+    paired_config_init(&paired, &a, &b, 20000, 29);
+    PairedResults whole = {0};
+    assert(paired_run(&paired, &whole));
+
+    PairedResults halves = {0};
+    for (int h = 0; h < 2; h++) {
+        PairedConfig half = paired;
+        half.config.num_hands = 10000;
+        half.config.first_shoe = h * 10000;
+        PairedResults part = {0};
+        assert(paired_run(&half, &part));
+        paired_results_add(&halves, &part);
+    }
+    assert(halves.rounds == whole.rounds);
+    assert(halves.diverged == whole.diverged);
+    assert(halves.total_a == whole.total_a);
+    assert(halves.difference_squared == whole.difference_squared);
+}
+
+TEST(rules_that_change_the_game_are_rejected) {
+    Rules a, b;
+    rules_init(&a);
+    b = a;
+    b.num_decks = 2;
+    assert(!paired_rules_supported(&a, &b));
+    b = a;
+    b.dealer_peeks_blackjack = false;
+    assert(!paired_rules_supported(&a, &b));
+
+    PairedConfig paired;
+    paired_config_init(&paired, &a, &b, 100, 31);
+    PairedResults results = {0};
+    assert(!paired_run(&paired, &results));
+    assert(results.rounds == 0);
+
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+    paired_config_init(&paired, &a, &a, 100, 31);
+    paired.config.count_systems = &hi_lo;
+    paired.config.num_count_systems = 1;
+    assert(!paired_run(&paired, &results));
+}
+
+int main(void) {
+    printf("Running Paired Tests\n");
+    printf("==================================\n\n");
+
+    run_test_each_side_matches_its_own_run();
+    run_test_same_rules_never_diverge();
+    run_test_h17_difference_is_measured_on_the_rounds_it_changes();
+    run_test_halves_add_up_to_the_whole();
+    run_test_rules_that_change_the_game_are_rejected();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/payout.h"
+#include "../src/lanes.h"
+#include "../src/simulation.h"
+#include "simulation_fixtures.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+static void score_rules(const SimulationResults* results, const Rules* rules, PayoutScore* score) {
+    PayoutVariant variant;
+    payout_variant_from_rules(&variant, rules);
+    payout_score(&results->payouts, &variant, score);
+}
+
+// ============================================================================
+// PAYOUT TESTS
+// ============================================================================
+
+TEST(categories_split_by_doubling_and_splitting) {
+    assert(payout_category(HAND_NATURAL, false, false) == PAYOUT_NATURAL);
+    assert(payout_category(HAND_SURRENDER, false, false) == PAYOUT_SURRENDER);
+    assert(payout_category(HAND_WIN, false, false) == PAYOUT_WIN);
+    assert(payout_category(HAND_PUSH, true, false) == PAYOUT_DOUBLED_PUSH);
+    assert(payout_category(HAND_LOSE, false, true) == PAYOUT_SPLIT_LOSE);
+    assert(payout_category(HAND_WIN, true, true) == PAYOUT_SPLIT_DOUBLED_WIN);
+    for (int c = 0; c < PAYOUT_NUM_CATEGORIES; c++) {
+        assert(payout_category_name(c) != NULL);
+    }
+}
+
+// Six hand-built rounds, scored 6:5 with every ace insured at 2:1, against
+// the same rounds' results worked out directly
+TEST(score_matches_rounds_worked_by_hand) {
+    PayoutTable table = {0};
+
+    // Natural against an ace without blackjack: 1.2 - 0.5
+    payout_table_record_hand(&table, HAND_NATURAL, false, false);
+    payout_table_record_round(&table, 1.5, true, true, false);
+    // Lose to an ace with blackjack: -1 + 1
+    payout_table_record_hand(&table, HAND_LOSE, false, false);
+    payout_table_record_round(&table, -1.0, false, true, true);
+    // Doubled win against a ten
+    payout_table_record_hand(&table, HAND_WIN, true, false);
+    payout_table_record_round(&table, 2.0, false, false, false);
+    // Split against an ace: win one, lose one doubled, lose the insurance
+    payout_table_record_hand(&table, HAND_WIN, false, true);
+    payout_table_record_hand(&table, HAND_LOSE, true, true);
+    payout_table_record_round(&table, -1.0, false, true, false);
+    // Surrender against an ace, insurance lost
+    payout_table_record_hand(&table, HAND_SURRENDER, false, false);
+    payout_table_record_round(&table, -0.5, false, true, false);
+    // Natural pushes a dealer blackjack, insurance won
+    payout_table_record_hand(&table, HAND_PUSH, false, false);
+    payout_table_record_round(&table, 0.0, false, true, true);
+
+    double expected[] = { 0.7, 0.0, 2.0, -1.5, -1.0, 1.0 };
+    int n = 6;
+    double mean = 0.0;
+    for (int r = 0; r < n; r++) {
+        mean += expected[r] / n;
+    }
+    double variance = 0.0;
+    for (int r = 0; r < n; r++) {
+        variance += (expected[r] - mean) * (expected[r] - mean) / (n - 1);
+    }
+
+    PayoutVariant variant = { 1.2, 2.0, true };
+    PayoutScore score;
+    payout_score(&table, &variant, &score);
+    assert(fabs(score.ev - mean) < 1e-12);
+    assert(fabs(score.standard_error - sqrt(variance / n)) < 1e-12);
+    // Two insurance bets won of five
+    assert(fabs(score.insurance_ev - (2.0 * 2 - 3) / 5) < 1e-12);
+}
+
+TEST(rules_payouts_reproduce_the_run) {
+    SimulationConfig config;
+    simulation_config_init(&config, 200000, 48, 0);
+    SimulationResults results = {0};
+    lanes_run(&config, &results);
+
+    // Whole half units throughout, so the rescored mean is exact
+    PayoutScore score;
+    score_rules(&results, &config.rules, &score);
+    assert(results.payouts.rounds == results.hands_played);
+    assert(score.ev == simulation_get_ev_per_round(&results));
+    assert(fabs(score.standard_error - simulation_get_ev_standard_error(&results)) < 1e-12);
+}
+
+// One 3:2 run rescored for 6:5 and 1:1 against runs actually paid that way
+TEST(rescored_payouts_match_runs_at_those_payouts) {
+    double payouts[] = { 1.2, 1.0 };
+    for (int p = 0; p < 2; p++) {
+        for (int counting = 0; counting < 2; counting++) {
+            static CountSystem hi_lo;
+            count_system_hi_lo(&hi_lo);
+
+            SimulationConfig config;
+            simulation_config_init(&config, 60000, 49, 0);
+            config.rules.num_decks = 2;
+            config.rules.dealer_hits_soft_17 = true;
+            if (counting) {
+                config.count_systems = &hi_lo;
+                config.num_count_systems = 1;
+            }
+            SimulationResults three_to_two = {0};
+            simulation_run(&config, &three_to_two);
+
+            config.rules.blackjack_payout = payouts[p];
+            SimulationResults paid = {0};
+            simulation_run(&config, &paid);
+            assert(paid.hands_played == three_to_two.hands_played);
+
+            PayoutScore score;
+            score_rules(&three_to_two, &config.rules, &score);
+            assert(fabs(score.ev - simulation_get_ev_per_round(&paid)) < 1e-12);
+            assert(fabs(score.standard_error - simulation_get_ev_standard_error(&paid)) < 1e-12);
+        }
+    }
+}
+
+TEST(insurance_is_a_losing_bet_off_the_top) {
+    SimulationConfig config;
+    simulation_config_init(&config, 400000, 50, 0);
+    SimulationResults results = {0};
+    lanes_run(&config, &results);
+
+    PayoutVariant variant;
+    payout_variant_from_rules(&variant, &config.rules);
+    PayoutScore declined, insured;
+    payout_score(&results.payouts, &variant, &declined);
+    variant.insure = true;
+    payout_score(&results.payouts, &variant, &insured);
+
+    // Six decks: about 30.9% of aces have a ten under them, so 2:1 loses ~7%
+    assert(declined.insurance_ev > -0.12 && declined.insurance_ev < -0.03);
+    assert(insured.insurance_ev == declined.insurance_ev);
+
+    long aces = results.payouts.insurance_wins + results.payouts.insurance_losses;
+    double cost = 0.5 * declined.insurance_ev * aces / results.hands_played;
+    assert(fabs(insured.ev - declined.ev - cost) < 1e-12);
+    assert(aces > results.hands_played / 15 && aces < results.hands_played / 11);
+}
+
+TEST(tables_add_up) {
+    SimulationConfig config;
+    simulation_config_init(&config, 30000, 51, 0);
+    SimulationResults whole = {0};
+    simulation_run(&config, &whole);
+
+    SimulationResults halves = {0};
+    for (int h = 0; h < 2; h++) {
+        SimulationConfig half = config;
+        half.num_hands = 15000;
+        half.first_shoe = h * 15000;
+        SimulationResults part = {0};
+        simulation_run(&half, &part);
+        simulation_results_add(&halves, &part, 0);
+    }
+    for (int c = 0; c < PAYOUT_NUM_CATEGORIES; c++) {
+        assert(halves.payouts.hands[c] == whole.payouts.hands[c]);
+    }
+    assert(halves.payouts.result_squared == whole.payouts.result_squared);
+    assert(halves.payouts.insurance_wins == whole.payouts.insurance_wins);
+}
+
+int main(void) {
+    printf("Running Payout Tests\n");
+    printf("==================================\n\n");
+
+    run_test_categories_split_by_doubling_and_splitting();
+    run_test_score_matches_rounds_worked_by_hand();
+    run_test_rules_payouts_reproduce_the_run();
+    run_test_rescored_payouts_match_runs_at_those_payouts();
+    run_test_insurance_is_a_losing_bet_off_the_top();
+    run_test_tables_add_up();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
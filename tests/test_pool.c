@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../src/pool.h"
+#include "../src/lanes.h"
+#include "../src/deck.h"
+#include "simulation_fixtures.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+static CountSystem hi_lo;
+
+// Cheap and expensive jobs side by side: a flat 8 deck game in big chunks,
+// a counted single deck game and a wonged 6 deck game in small ones
+static void add_mixed_jobs(Pool* pool) {
+    SimulationConfig config;
+
+    simulation_config_init(&config, 120000, 11, 3);
+    config.rules.num_decks = 8;
+    assert(pool_add_job(pool, &config, 16384) == 0);
+
+    simulation_config_init(&config, 30000, 12, 3);
+    config.rules.num_decks = 1;
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+    assert(pool_add_job(pool, &config, 2500) == 1);
+
+    simulation_config_init(&config, 20000, 13, 3);
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+    config.wonging = true;
+    config.wong_in = 1.0;
+    config.wong_out = 0.0;
+    assert(pool_add_job(pool, &config, 1500) == 2);
+}
+
+// ============================================================================
+// POOL TESTS
+// ============================================================================
+
+TEST(chunked_job_matches_one_run) {
+    SimulationConfig config;
+    simulation_config_init(&config, 100003, 777, 3);
+
+    Pool pool;
+    assert(pool_init(&pool, 3));
+    int job = pool_add_job(&pool, &config, 4096);
+    assert(pool_run(&pool));
+    assert(pool.jobs[job].num_tasks == 25);
+    assert(pool.tasks_run == 25);
+
+    // Fresh-shoe tasks deal the shoes one run of the whole job would, and
+    // payouts are whole half units, so even the sums match exactly
+    SimulationResults whole = {0};
+    lanes_run(&config, &whole);
+    assert_same_results(pool_job_results(&pool, job), &whole);
+    pool_destroy(&pool);
+}
+
+TEST(results_do_not_depend_on_thread_count) {
+    static SimulationResults reference[3];
+    int thread_counts[] = { 1, 2, 5, 16 };
+
+    for (int t = 0; t < 4; t++) {
+        Pool pool;
+        assert(pool_init(&pool, thread_counts[t]));
+        add_mixed_jobs(&pool);
+        assert(pool_run(&pool));
+        assert(pool.tasks_run == 8 + 12 + 14);
+        if (thread_counts[t] == 1) {
+            assert(pool.tasks_stolen == 0);
+        }
+
+        for (int j = 0; j < 3; j++) {
+            if (t == 0) {
+                reference[j] = *pool_job_results(&pool, j);
+            } else {
+                assert_same_results(pool_job_results(&pool, j), &reference[j]);
+            }
+        }
+        pool_destroy(&pool);
+    }
+
+    assert(reference[0].hands_played == 120000);
+    assert(reference[1].hands_played == 30000);
+    assert(reference[2].hands_played + reference[2].rounds_sat_out == 20000);
+    assert(reference[2].rounds_sat_out > 0);
+}
+
+TEST(counting_task_is_its_own_shoe_sequence) {
+    SimulationConfig config;
+    simulation_config_init(&config, 9000, 4242, 3);
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+
+    Pool pool;
+    assert(pool_init(&pool, 4));
+    int job = pool_add_job(&pool, &config, 4000);
+    assert(pool_run(&pool));
+
+    // Task k starts from shoe first_shoe + k * DECK_SHOES_PER_INIT
+    SimulationResults expected = {0};
+    for (int k = 0; k < 3; k++) {
+        SimulationConfig task_config = config;
+        task_config.num_hands = k < 2 ? 4000 : 1000;
+        task_config.first_shoe = config.first_shoe + (uint64_t)k * DECK_SHOES_PER_INIT;
+        SimulationResults task_results = {0};
+        simulation_run(&task_config, &task_results);
+        simulation_results_add(&expected, &task_results, 1);
+    }
+    assert_same_results(pool_job_results(&pool, job), &expected);
+    pool_destroy(&pool);
+}
+
+// One pool, its threads and their shoes and games kept, across jobs whose
+// deck counts and split limits change in between
+TEST(pool_is_reused_across_runs) {
+    SimulationConfig configs[3];
+    simulation_config_init(&configs[0], 40000, 21, 3);
+    simulation_config_init(&configs[1], 30000, 22, 3);
+    configs[1].rules.num_decks = 2;
+    configs[1].rules.max_splits = 1;
+    simulation_config_init(&configs[2], 9000, 23, 3);
+    configs[2].count_systems = &hi_lo;
+    configs[2].num_count_systems = 1;
+
+    Pool pool;
+    assert(pool_init(&pool, 3));
+    for (int pass = 0; pass < 2; pass++) {
+        for (int c = 0; c < 3; c++) {
+            SimulationResults reused;
+            assert(pool_simulate(&pool, &configs[c], 4000, &reused));
+
+            Pool fresh;
+            assert(pool_init(&fresh, 2));
+            int job = pool_add_job(&fresh, &configs[c], 4000);
+            assert(pool_run(&fresh));
+            assert_same_results(&reused, pool_job_results(&fresh, job));
+            pool_destroy(&fresh);
+        }
+    }
+    assert(pool.num_jobs == 1);
+    pool_destroy(&pool);
+}
+
+TEST(pinned_pools_match_unpinned) {
+    static SimulationResults reference[3];
+    PoolPinning pinnings[] = { POOL_PIN_NONE, POOL_PIN_CORES, POOL_PIN_NODES };
+    assert(pool_num_nodes() >= 1);
+
+    for (int p = 0; p < 3; p++) {
+        Pool pool;
+        assert(pool_init_pinned(&pool, 3, pinnings[p]));
+        add_mixed_jobs(&pool);
+        assert(pool_run(&pool));
+        for (int j = 0; j < 3; j++) {
+            if (p == 0) {
+                reference[j] = *pool_job_results(&pool, j);
+            } else {
+                assert_same_results(pool_job_results(&pool, j), &reference[j]);
+            }
+        }
+        pool_destroy(&pool);
+    }
+}
+
+TEST(rejects_unseeded_jobs) {
+    SimulationConfig config;
+    Pool pool;
+    assert(pool_init(&pool, 2));
+
+    simulation_config_init(&config, 1000, 0, 3);
+    assert(pool_add_job(&pool, &config, 100) == -1);
+    simulation_config_init(&config, 0, 5, 3);
+    assert(pool_add_job(&pool, &config, 100) == -1);
+    assert(pool.num_jobs == 0);
+
+    // Nothing to do is not an error
+    assert(pool_run(&pool));
+    assert(pool.tasks_run == 0);
+    pool_destroy(&pool);
+}
+
+int main(void) {
+    printf("Running Pool Tests\n");
+    printf("==================================\n\n");
+
+    count_system_hi_lo(&hi_lo);
+
+    run_test_chunked_job_matches_one_run();
+    run_test_results_do_not_depend_on_thread_count();
+    run_test_counting_task_is_its_own_shoe_sequence();
+    run_test_pool_is_reused_across_runs();
+    run_test_pinned_pools_match_unpinned();
+    run_test_rejects_unseeded_jobs();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
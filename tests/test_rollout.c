@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/rollout.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+#define TEN 9
+#define ACE 0
+
+// A fresh lazy six-deck shoe with the round's cards set by hand
+static void setup(GameState* game, SimulationConfig* config, int player_a, int player_b, int upcard, int hole_card) {
+    *config = (SimulationConfig){0};
+    rules_init(&config->rules);
+    basic_strategy_for_rules(&config->strategy, &config->rules, NULL);
+    config->bet_per_hand = 1.0;
+
+    game_init(game, &config->rules, 1.0);
+    deck_set_mode(&game->deck, DECK_SHUFFLE_LAZY);
+    deck_seed(&game->deck, 3141, 0);
+    deck_shuffle(&game->deck);
+    game_reset_round(game, 1.0);
+    hand_add_card(&game->player_hands[0], player_a);
+    hand_add_card(&game->player_hands[0], player_b);
+    game->num_player_hands = 1;
+    hand_add_card(&game->dealer_hand, upcard);
+    hand_add_card(&game->dealer_hand, hole_card);
+}
+
+// ============================================================================
+// ROLLOUT TESTS
+// ============================================================================
+
+// Standing or surrendering against a dealer who stands has one outcome
+TEST(settled_actions_have_no_spread) {
+    GameState game;
+    SimulationConfig config;
+    setup(&game, &config, TEN, TEN, TEN, 8);  // 20 against 19
+
+    RolloutResult stand = {0};
+    assert(rollout_action(&game, &config, 0, STAND, 1000, &stand));
+    assert(stand.rollouts == 1000);
+    assert(rollout_get_ev(&stand) == 1.0);
+    assert(rollout_get_standard_error(&stand) == 0.0);
+
+    RolloutResult surrender = {0};
+    assert(rollout_action(&game, &config, 0, SURRENDER, 10, &surrender));
+    assert(rollout_get_ev(&surrender) == -0.5);
+    game_destroy(&game);
+}
+
+TEST(clear_decisions_come_out_best) {
+    struct { int player_a, player_b, upcard, hole_card; PlayerAction best; } cases[] = {
+        { TEN, TEN, TEN, 8, STAND },   // 20 against 19
+        { 4, 5, 5, TEN, DOUBLE },      // 11 against 16
+        { 7, 7, 5, TEN, SPLIT },       // 8,8 against 16
+        { 2, 3, TEN, 6, HIT },         // Hard 7 against 17
+        { TEN, 5, TEN, 8, SURRENDER }, // 16 against 19
+    };
+
+    for (int c = 0; c < 5; c++) {
+        GameState game;
+        SimulationConfig config;
+        setup(&game, &config, cases[c].player_a, cases[c].player_b, cases[c].upcard, cases[c].hole_card);
+
+        RolloutResult results[ROLLOUT_NUM_ACTIONS];
+        PlayerAction best = rollout_best_action(&game, &config, 0, 4000, results);
+        assert(best == cases[c].best);
+        assert(results[best].rollouts == 4000);
+        assert(results[STAND].rollouts == 4000);
+        game_destroy(&game);
+    }
+}
+
+// Rollouts leave the game, shoe included, exactly where they found it
+TEST(game_is_left_as_given) {
+    GameState game, untouched;
+    SimulationConfig config;
+    setup(&game, &config, 7, 7, 5, 3);
+    setup(&untouched, &config, 7, 7, 5, 3);
+
+    RolloutResult results[ROLLOUT_NUM_ACTIONS];
+    rollout_best_action(&game, &config, 0, 500, results);
+
+    assert(game.num_player_hands == 1);
+    assert(game.player_hands[0].num_cards == 2);
+    assert(game.player_hands[1].num_cards == 0);
+    assert(game.player_bets[0] == 1.0);
+    assert(game.dealer_hand.num_cards == 2);
+    assert(game.deck.position == untouched.deck.position);
+    for (int i = 0; i < 60; i++) {
+        assert(deck_deal(game.shoe) == deck_deal(untouched.shoe));
+    }
+    game_destroy(&game);
+    game_destroy(&untouched);
+}
+
+// Rollout i of each action deals from the same branch of the shoe, the same
+// every time it is asked
+TEST(rollouts_are_reproducible_and_paired) {
+    GameState game;
+    SimulationConfig config;
+    setup(&game, &config, TEN, 4, 5, TEN);  // 15 against 16
+
+    RolloutResult first = {0}, again = {0}, doubled = {0}, stand = {0};
+    rollout_action(&game, &config, 0, HIT, 2000, &first);
+    rollout_action(&game, &config, 0, HIT, 2000, &again);
+    rollout_action(&game, &config, 0, DOUBLE, 2000, &doubled);
+    rollout_action(&game, &config, 0, STAND, 2000, &stand);
+    assert(first.total == again.total);
+    assert(first.total_squared == again.total_squared);
+
+    // Any card makes 15 a hard 16 or more, which stands against a six, so
+    // each doubled rollout is its hit rollout at twice the bet
+    assert(doubled.total == 2.0 * first.total);
+
+    // The dealer busts 16 with any 6 or more; standing wins exactly then
+    double bust = (stand.total / stand.rollouts + 1.0) / 2.0;
+    assert(fabs(bust - 8.0 / 13.0) < 0.05);
+    game_destroy(&game);
+}
+
+TEST(unusable_shoes_and_illegal_actions_are_rejected) {
+    GameState game;
+    SimulationConfig config;
+    setup(&game, &config, TEN, 4, 5, TEN);
+    RolloutResult result = {0};
+
+    assert(!rollout_action(&game, &config, 0, SPLIT, 10, &result));
+    game_play_action(&game, HIT, 0);
+    assert(!rollout_action(&game, &config, 0, DOUBLE, 10, &result));
+    assert(!rollout_action(&game, &config, 0, SURRENDER, 10, &result));
+    assert(result.rollouts == 0);
+
+    deck_set_mode(&game.deck, DECK_SHUFFLE_FULL);
+    assert(!rollout_action(&game, &config, 0, STAND, 10, &result));
+    game_destroy(&game);
+}
+
+int main(void) {
+    printf("Running Rollout Tests\n");
+    printf("==================================\n\n");
+
+    run_test_settled_actions_have_no_spread();
+    run_test_clear_decisions_come_out_best();
+    run_test_game_is_left_as_given();
+    run_test_rollouts_are_reproducible_and_paired();
+    run_test_unusable_shoes_and_illegal_actions_are_rejected();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
@@ -159,6 +159,23 @@ TEST(rules_comparison) {
     assert(rules1.num_decks == rules2.num_decks);
 }
 
+TEST(rules_same_play_ignores_payouts) {
+    Rules rules1, rules2;
+    rules_init(&rules1);
+    rules_init(&rules2);
+    assert(rules_same_play(&rules1, &rules2));
+
+    rules2.blackjack_payout = 1.2;
+    rules2.insurance_payout = 2.5;
+    assert(rules_same_play(&rules1, &rules2));
+
+    rules2.dealer_hits_soft_17 = true;
+    assert(!rules_same_play(&rules1, &rules2));
+    rules2 = rules1;
+    rules2.shoe_penetration = 0.8;
+    assert(!rules_same_play(&rules1, &rules2));
+}
+
 int main(void) {
     printf("Running Game Rules Tests\n");
     printf("==================================\n\n");
@@ -175,6 +192,7 @@ int main(void) {
     run_test_custom_rules_max_splits();
     run_test_rules_european_no_hole_card();
     run_test_rules_comparison();
+    run_test_rules_same_play_ignores_payouts();
 
     printf("\n==================================\n");
     printf("Tests passed: %d/%d\n", tests_passed, tests_run);
@@ -1,10 +1,15 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <assert.h>
 #include <stdbool.h>
 #include <math.h>
 #include <string.h>
 // Uncomment these as you create the headers
+#include <stdlib.h>
+#include <unistd.h>
 #include "../src/strategy.h"
+#include "../src/chart.h"
+#include "../src/strategy_file.h"
 #include "../src/simulation.h"
 #include "../src/game.h"
 #include "../src/hand.h"
@@ -322,7 +327,7 @@ TEST(strategy_pair_9s_special_cases) {
 // double simulation_get_ev(SimulationResults* results) - Calculate expected value
 
 TEST(simulation_initialization) {
-    SimulationConfig config;
+    SimulationConfig config = {0};
     rules_init(&config.rules);
     basic_strategy_init(&config.strategy);
     config.num_hands = 1000;
@@ -341,7 +346,7 @@ TEST(simulation_initialization) {
 }
 
 TEST(simulation_double_and_split_actions) {
-    SimulationConfig config;
+    SimulationConfig config = {0};
     rules_init(&config.rules);
     basic_strategy_init(&config.strategy);
     config.num_hands = 10000;  // Larger sample to ensure doubles/splits occur
@@ -370,10 +375,10 @@ TEST(simulation_double_and_split_actions) {
 }
 
 TEST(simulation_basic_strategy_ev) {
-    SimulationConfig config;
+    SimulationConfig config = {0};
     rules_init(&config.rules);
     basic_strategy_init(&config.strategy);
-    config.num_hands = 100000;  // Large sample to converge to true EV
+    config.num_hands = 1000000;  // Large sample to converge to true EV
     config.bet_per_hand = 1.0;
 
     SimulationResults results = {0};
@@ -410,7 +415,7 @@ TEST(simulation_ev_variance_across_seeds) {
     for (int i = 0; i < num_seeds; i++) {
         deck_set_rng_seed(seeds[i]);
 
-        SimulationConfig config;
+        SimulationConfig config = {0};
         rules_init(&config.rules);
         basic_strategy_init(&config.strategy);
         config.num_hands = 100000;
@@ -1016,6 +1021,190 @@ TEST(strategy_verify_all_pairs) {
     assert(errors == 0);
 }
 
+// Every compiled chart loads by name, and the S17 chart differs from the
+// default in exactly the three H17 doubles
+TEST(strategy_charts_load_by_name) {
+    BasicStrategy default_chart;
+    basic_strategy_init(&default_chart);
+
+    assert(basic_strategy_num_charts() >= 2);
+    for (int c = 0; c < basic_strategy_num_charts(); c++) {
+        BasicStrategy strategy;
+        assert(basic_strategy_load(&strategy, basic_strategy_chart_name(c)));
+    }
+    assert(basic_strategy_chart_name(basic_strategy_num_charts()) == NULL);
+
+    BasicStrategy untouched = default_chart;
+    assert(!basic_strategy_load(&untouched, "no_such_chart"));
+    assert(memcmp(&untouched, &default_chart, sizeof(BasicStrategy)) == 0);
+
+    BasicStrategy s17;
+    assert(basic_strategy_load(&s17, "s17_das_ls"));
+    int differences = 0;
+    for (int d = 0; d < 10; d++) {
+        for (int h = 0; h < 9; h++) {
+            differences += s17.hard_totals[d][h] != default_chart.hard_totals[d][h];
+        }
+        for (int h = 0; h < 8; h++) {
+            differences += s17.soft_totals[d][h] != default_chart.soft_totals[d][h];
+        }
+        for (int h = 0; h < 10; h++) {
+            differences += s17.pairs[d][h] != default_chart.pairs[d][h];
+        }
+        for (int h = 0; h < 3; h++) {
+            differences += s17.surrender[d][h] != default_chart.surrender[d][h];
+        }
+    }
+    assert(differences == 3);
+    assert(s17.hard_totals[9][3] == HIT);            // 11 v A
+    assert(s17.soft_totals[0][5] == SOFT_STAND);     // A-7 v 2
+    assert(s17.soft_totals[4][6] == SOFT_STAND);     // A-8 v 6
+}
+
+// Charts follow the deck count and soft 17; rules none is made for get the
+// nearest chart and exact = false
+TEST(strategy_for_rules_follows_decks) {
+    Rules rules;
+    rules_init(&rules);
+    BasicStrategy strategy;
+    bool exact;
+    struct { int decks; bool h17; const char* chart; } cases[] = {
+        { 1, false, "1deck_s17_das_ls" }, { 1, true, "1deck_h17_das_ls" },
+        { 2, false, "2deck_s17_das_ls" }, { 2, true, "2deck_h17_das_ls" },
+        { 6, false, "s17_das_ls" },       { 8, true, "h17_das_ls" },
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        rules.num_decks = cases[c].decks;
+        rules.dealer_hits_soft_17 = cases[c].h17;
+        assert(strcmp(basic_strategy_for_rules(&strategy, &rules, &exact), cases[c].chart) == 0);
+        assert(exact);
+    }
+
+    rules.num_decks = 3;
+    assert(strcmp(basic_strategy_for_rules(&strategy, &rules, &exact), "h17_das_ls") == 0);
+    assert(!exact);
+    rules.num_decks = 6;
+    rules.dealer_peeks_blackjack = false;
+    basic_strategy_for_rules(&strategy, &rules, &exact);
+    assert(!exact);
+
+    // Fewer decks double more: 11 v A and 9 v 2
+    rules.dealer_peeks_blackjack = true;
+    rules.num_decks = 1;
+    rules.dealer_hits_soft_17 = false;
+    basic_strategy_for_rules(&strategy, &rules, NULL);
+    assert(strategy.hard_totals[9][3] == DOUBLE);
+    assert(strategy.hard_totals[0][1] == DOUBLE);
+}
+
+static void temporary_path(char* path) {
+    strcpy(path, "/tmp/blackjack_strategies_XXXXXX");
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+}
+
+TEST(chart_text_round_trips) {
+    BasicStrategy s17;
+    assert(basic_strategy_load(&s17, "s17_das_ls"));
+
+    FILE* text = tmpfile();
+    assert(text != NULL);
+    chart_write(text, "s17_das_ls", &s17);
+    rewind(text);
+
+    char name[CHART_NAME_LENGTH];
+    BasicStrategy read_back;
+    memset(&read_back, 0, sizeof(read_back));
+    assert(chart_read(text, "round trip", name, &read_back));
+    fclose(text);
+
+    assert(strcmp(name, "s17_das_ls") == 0);
+    assert(memcmp(&read_back, &s17, sizeof(BasicStrategy)) == 0);
+}
+
+TEST(strategy_file_is_used_in_place) {
+    StrategyRecord records[2];
+    memset(records, 0, sizeof(records));
+    strcpy(records[0].name, "default");
+    basic_strategy_init(&records[0].strategy);
+    strcpy(records[1].name, "s17_das_ls");
+    basic_strategy_load(&records[1].strategy, "s17_das_ls");
+
+    char path[64];
+    temporary_path(path);
+    assert(strategy_file_save(path, records, 2));
+
+    StrategyFile file;
+    assert(strategy_file_open(&file, path));
+    assert(file.num_strategies == 2);
+
+    // Found strategies point straight into the mapping
+    const BasicStrategy* s17 = strategy_file_find(&file, "s17_das_ls");
+    assert(s17 == &file.records[1].strategy);
+    assert((const char*)s17 > (const char*)file.mapping);
+    assert((const char*)s17 < (const char*)file.mapping + file.mapping_size);
+    assert(memcmp(s17, &records[1].strategy, sizeof(BasicStrategy)) == 0);
+    assert(strategy_file_find(&file, "missing") == NULL);
+
+    // Lookups take the mapped table as it is
+    Rules rules;
+    rules_init(&rules);
+    Hand hand;
+    hand_init(&hand);
+    hand_add_card(&hand, 0);   // A
+    hand_add_card(&hand, 6);   // 7: soft 18
+    assert(get_basic_strategy_action(&hand, 1, &rules, s17, false, true, false) == STAND);   // v 2
+    hand_destroy(&hand);
+
+    strategy_file_close(&file);
+    assert(file.mapping == NULL);
+    remove(path);
+}
+
+TEST(strategy_file_rejects_damage) {
+    StrategyRecord record;
+    memset(&record, 0, sizeof(record));
+    strcpy(record.name, "default");
+    basic_strategy_init(&record.strategy);
+
+    char path[64];
+    temporary_path(path);
+    assert(strategy_file_save(path, &record, 1));
+
+    // One flipped cell fails the checksum
+    FILE* file = fopen(path, "r+b");
+    long cell = (long)(sizeof(StrategyFileHeader) + CHART_NAME_LENGTH + 17);
+    fseek(file, cell, SEEK_SET);
+    int byte = fgetc(file);
+    fseek(file, cell, SEEK_SET);
+    fputc(byte ^ 1, file);
+    fclose(file);
+
+    printf("\n  Expect three errors: ");
+    StrategyFile strategies;
+    assert(!strategy_file_open(&strategies, path));
+
+    // A cell no chart symbol stands for fails too, even under a good checksum
+    uint8_t* surrender_bytes = (uint8_t*)record.strategy.surrender;
+    surrender_bytes[0] = 2;
+    assert(!chart_strategy_valid(&record.strategy));
+    assert(strategy_file_save(path, &record, 1));
+    assert(!strategy_file_open(&strategies, path));
+    surrender_bytes[0] = 0;
+    record.strategy.hard_totals[3][4] = SPLIT;
+    assert(!chart_strategy_valid(&record.strategy));
+    record.strategy.hard_totals[3][4] = STAND;
+    assert(chart_strategy_valid(&record.strategy));
+
+    // A text file isn't mistaken for one
+    file = fopen(path, "w");
+    fputs("chart default\n", file);
+    fclose(file);
+    assert(!strategy_file_open(&strategies, path));
+    remove(path);
+}
+
 // ============================================================================
 // INSURANCE TESTS
 // ============================================================================
@@ -1287,7 +1476,7 @@ TEST(insurance_frequency_in_simulation) {
 }
 
 // TEST(simulation_win_rate) {
-//     SimulationConfig config;
+//     SimulationConfig config = {0};
 //     rules_init(&config.rules);
 //     config.num_hands = 10000;
 //     config.use_basic_strategy = true;
@@ -1309,7 +1498,7 @@ TEST(insurance_frequency_in_simulation) {
 // }
 
 // TEST(simulation_blackjack_frequency) {
-//     SimulationConfig config;
+//     SimulationConfig config = {0};
 //     rules_init(&config.rules);
 //     config.num_hands = 10000;
 //     config.use_basic_strategy = true;
@@ -1419,6 +1608,11 @@ int main(void) {
     run_test_strategy_verify_all_hard_totals();
     run_test_strategy_verify_all_soft_totals();
     run_test_strategy_verify_all_pairs();
+    run_test_strategy_charts_load_by_name();
+    run_test_strategy_for_rules_follows_decks();
+    run_test_chart_text_round_trips();
+    run_test_strategy_file_is_used_in_place();
+    run_test_strategy_file_rejects_damage();
 
     run_test_simulation_basic_strategy_ev();
     run_test_simulation_ev_variance_across_seeds();
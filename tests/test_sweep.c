@@ -0,0 +1,282 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "../src/sweep.h"
+#include "../src/pool.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+static void add_grid(Sweep* sweep, const char* text) {
+    SweepGrid grid;
+    assert(sweep_parse_grid(text, "test", &grid));
+    assert(sweep_add_grid(sweep, &grid));
+}
+
+static int count_lines(const char* text) {
+    int lines = 0;
+    for (; *text != '\0'; text++) {
+        lines += *text == '\n';
+    }
+    return lines;
+}
+
+// ============================================================================
+// SWEEP TESTS
+// ============================================================================
+
+TEST(grid_expands_to_every_combination) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    add_grid(&sweep, "decks=1,2,6,8 h17=0,1 payout=3:2,6:5");
+    assert(sweep.num_entries == 16);
+
+    // Last axis fastest; unnamed rules keep their defaults
+    assert(sweep.entries[0].rules.num_decks == 1);
+    assert(!sweep.entries[0].rules.dealer_hits_soft_17);
+    assert(sweep.entries[0].rules.blackjack_payout == 1.5);
+    assert(sweep.entries[1].rules.blackjack_payout == 1.2);
+    assert(sweep.entries[2].rules.dealer_hits_soft_17);
+    assert(sweep.entries[15].rules.num_decks == 8);
+    assert(sweep.entries[15].rules.double_after_split);
+    assert(sweep.entries[15].rules.max_splits == 3);
+
+    // An empty grid is the default rules
+    add_grid(&sweep, "");
+    assert(sweep.num_entries == 17);
+    assert(sweep.entries[16].rules.num_decks == 6);
+    sweep_destroy(&sweep);
+}
+
+TEST(bad_grids_are_rejected) {
+    SweepGrid grid;
+    fprintf(stderr, "\n");
+    assert(!sweep_parse_grid("colour=red", "test", &grid));
+    assert(!sweep_parse_grid("decks", "test", &grid));
+    assert(!sweep_parse_grid("decks=", "test", &grid));
+    assert(!sweep_parse_grid("decks=0", "test", &grid));
+    assert(!sweep_parse_grid("decks=2.5", "test", &grid));
+    assert(!sweep_parse_grid("h17=2", "test", &grid));
+    assert(!sweep_parse_grid("payout=3:0", "test", &grid));
+    assert(!sweep_parse_grid("decks=1 decks=2", "test", &grid));
+    assert(sweep_parse_grid("penetration=0.5,0.8 surrender=0", "test", &grid));
+}
+
+TEST(list_file_adds_a_grid_per_line) {
+    char path[] = "/tmp/test_sweep_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    FILE* file = fdopen(fd, "w");
+    fprintf(file, "# Single deck games\n\ndecks=1 h17=0,1\n  decks=6,8 das=0,1 surrender=0,1\n");
+    fclose(file);
+
+    Sweep sweep;
+    sweep_init(&sweep);
+    assert(sweep_add_list(&sweep, path));
+    assert(sweep.num_entries == 2 + 8);
+    sweep_destroy(&sweep);
+
+    file = fopen(path, "w");
+    fprintf(file, "decks=1\nsplits=9\n");
+    fclose(file);
+    sweep_init(&sweep);
+    assert(!sweep_add_list(&sweep, path));
+    sweep_destroy(&sweep);
+    remove(path);
+}
+
+TEST(each_configuration_streams_one_line_in_order) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    sweep.rounds = 20000;
+    sweep.num_threads = 3;
+    add_grid(&sweep, "decks=1,6 h17=0,1 das=0,1");
+
+    char* text;
+    size_t size;
+    FILE* out = open_memstream(&text, &size);
+    assert(sweep_run(&sweep, out));
+    fclose(out);
+
+    assert(count_lines(text) == 8);
+    const char* line = text;
+    for (int e = 0; e < sweep.num_entries; e++) {
+        int decks;
+        char soft17[8];
+        assert(sscanf(line, "%d %7s", &decks, soft17) == 2);
+        assert(decks == sweep.entries[e].rules.num_decks);
+        assert(strcmp(soft17, sweep.entries[e].rules.dealer_hits_soft_17 ? "H17" : "S17") == 0);
+        const char* chart = sweep.entries[e].rules.dealer_hits_soft_17 ? "h17_das_ls" : "s17_das_ls";
+        assert(strcmp(sweep.entries[e].chart, chart) == 0 || strcmp(sweep.entries[e].chart + strlen("1deck_"), chart) == 0);
+        assert(sweep.entries[e].exact_chart);
+        assert(sweep.entries[e].results.hands_played == 20000);
+        line = strchr(line, '\n') + 1;
+    }
+    free(text);
+    sweep_destroy(&sweep);
+}
+
+TEST(configuration_matches_its_own_pool_job) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    sweep.rounds = 150000;
+    sweep.num_threads = 2;
+    add_grid(&sweep, "decks=2 h17=1 payout=6:5");
+    assert(sweep_run(&sweep, NULL));
+
+    SimulationConfig config = {0};
+    config.rules = sweep.entries[0].rules;
+    basic_strategy_load(&config.strategy, "2deck_h17_das_ls");
+    config.num_hands = sweep.rounds;
+    config.bet_per_hand = 1.0;
+    config.seed = sweep.seed;
+
+    Pool pool;
+    pool_init(&pool, 1);
+    SimulationResults results;
+    pool_simulate(&pool, &config, SWEEP_ROUNDS_PER_TASK, &results);
+    pool_destroy(&pool);
+
+    SimulationResults* swept = &sweep.entries[0].results;
+    assert(swept->hands_played == results.hands_played);
+    assert(swept->total_payout == results.total_payout);
+    assert(swept->total_result == results.total_result);
+    assert(swept->total_result_squared == results.total_result_squared);
+    sweep_destroy(&sweep);
+}
+
+static double entry_ev(SweepEntry* entry) {
+    PayoutVariant variant;
+    PayoutScore score;
+    payout_variant_from_rules(&variant, &entry->rules);
+    payout_score(&entry->results.payouts, &variant, &score);
+    return score.ev;
+}
+
+// Payout variants share one simulation: 6:5 costs 0.3 units on each of the
+// same blackjacks, about 1.4% of the initial bet
+TEST(six_to_five_costs_the_blackjack_difference) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    sweep.rounds = 200000;
+    add_grid(&sweep, "payout=3:2,6:5");
+    assert(sweep_run(&sweep, NULL));
+    assert(sweep.num_jobs == 1);
+    assert(sweep.entries[0].job == sweep.entries[1].job);
+
+    long naturals = sweep.entries[0].results.payouts.hands[PAYOUT_NATURAL];
+    double difference = entry_ev(&sweep.entries[0]) - entry_ev(&sweep.entries[1]);
+    assert(fabs(difference - 0.3 * naturals / sweep.rounds) < 1e-12);
+    assert(difference > 0.0125 && difference < 0.015);
+
+    // The 3:2 line is the job's own result
+    assert(entry_ev(&sweep.entries[0]) == simulation_get_ev_per_round(&sweep.entries[0].results));
+    sweep_destroy(&sweep);
+}
+
+TEST(only_rules_that_change_play_add_jobs) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    sweep.rounds = 5000;
+    add_grid(&sweep, "decks=1,2 payout=3:2,7:5,6:5,1:1 h17=0,1");
+    assert(sweep_run(&sweep, NULL));
+    assert(sweep.num_entries == 16);
+    assert(sweep.num_jobs == 4);
+    sweep_destroy(&sweep);
+}
+
+// A fresh shoe every round never reaches the cut card
+TEST(penetration_only_adds_jobs_through_the_shoe) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    sweep.rounds = 5000;
+    add_grid(&sweep, "penetration=0.5,0.75");
+    assert(sweep_run(&sweep, NULL));
+    assert(sweep.num_jobs == 1);
+    assert(sweep.entries[0].results.total_result == sweep.entries[1].results.total_result);
+    sweep_destroy(&sweep);
+}
+
+// Rules no chart is made for get the nearest one, marked with a *
+TEST(rows_without_their_own_chart_are_marked) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    sweep.rounds = 5000;
+    add_grid(&sweep, "decks=3,6 peek=0,1");
+    assert(sweep_run(&sweep, NULL));
+    assert(sweep.num_entries == 4);
+    assert(!sweep.entries[0].exact_chart);       // 3 decks, no peek
+    assert(!sweep.entries[1].exact_chart);       // 3 decks
+    assert(!sweep.entries[2].exact_chart);       // No peek
+    assert(sweep.entries[3].exact_chart);
+
+    char* text;
+    size_t size;
+    FILE* out = open_memstream(&text, &size);
+    sweep_print_entry(out, &sweep, &sweep.entries[1]);
+    sweep_print_entry(out, &sweep, &sweep.entries[3]);
+    fclose(out);
+    assert(strstr(text, "_das_ls* ") != NULL);
+    assert(strstr(strchr(text, '\n'), "_das_ls ") != NULL);
+    free(text);
+    sweep_destroy(&sweep);
+}
+
+TEST(shoe_sweep_deals_down_to_the_penetration) {
+    Sweep sweep;
+    sweep_init(&sweep);
+    sweep.rounds = 30000;
+    sweep.through_shoe = true;
+    add_grid(&sweep, "decks=2 penetration=0.5,0.9");
+    assert(sweep_run(&sweep, NULL));
+
+    assert(sweep.entries[0].results.hands_played == 30000);
+    assert(sweep.entries[1].results.hands_played == 30000);
+    // Different cut cards put different cards in play
+    assert(sweep.entries[0].results.total_result != sweep.entries[1].results.total_result);
+    sweep_destroy(&sweep);
+}
+
+int main(void) {
+    printf("Running Sweep Tests\n");
+    printf("==================================\n\n");
+
+    run_test_grid_expands_to_every_combination();
+    run_test_bad_grids_are_rejected();
+    run_test_list_file_adds_a_grid_per_line();
+    run_test_each_configuration_streams_one_line_in_order();
+    run_test_configuration_matches_its_own_pool_job();
+    run_test_six_to_five_costs_the_blackjack_difference();
+    run_test_only_rules_that_change_play_add_jobs();
+    run_test_penetration_only_adds_jobs_through_the_shoe();
+    run_test_rows_without_their_own_chart_are_marked();
+    run_test_shoe_sweep_deals_down_to_the_penetration();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
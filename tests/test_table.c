@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/table.h"
+#include "../src/deck.h"
+
+// Simple test framework
+int tests_run = 0;
+int tests_passed = 0;
+
+#define TEST(name) \
+    void test_##name(); \
+    void run_test_##name() { \
+        printf("Running test: %s...", #name); \
+        tests_run++; \
+        test_##name(); \
+        tests_passed++; \
+        printf(" PASSED\n"); \
+    } \
+    void test_##name()
+
+static TableResults results;
+
+static void table_config_init(TableConfig* config, int num_seats, int num_rounds) {
+    TableConfig blank = {0};
+    *config = blank;
+    rules_init(&config->rules);
+    config->num_rounds = num_rounds;
+    config->num_seats = num_seats;
+
+    for (int s = 0; s < num_seats; s++) {
+        basic_strategy_init(&config->seats[s].strategy);
+        config->seats[s].bet_per_hand = 1.0;
+    }
+}
+
+// ============================================================================
+// TABLE TESTS
+// ============================================================================
+
+TEST(every_seat_plays_every_round) {
+    TableConfig config;
+    table_config_init(&config, 7, 5000);
+
+    TableResults blank = {0};
+    results = blank;
+    assert(table_run(&config, &results));
+
+    assert(results.rounds_dealt == 5000);
+    for (int s = 0; s < config.num_seats; s++) {
+        SimulationResults* seat = &results.seats[s];
+        assert(seat->hands_played == 5000);
+        assert(seat->hands_won + seat->hands_lost + seat->hands_pushed == 5000);
+        assert(seat->total_bet >= 5000.0);
+    }
+
+    // Same shoe, same strategy, different cards: the seats don't mirror each other
+    assert(results.seats[0].total_payout != results.seats[6].total_payout);
+}
+
+TEST(card_consumption_grows_with_seats) {
+    TableConfig config;
+    double cards_per_round[2];
+    int seat_counts[2] = { 1, 7 };
+
+    for (int i = 0; i < 2; i++) {
+        table_config_init(&config, seat_counts[i], 20000);
+        TableResults blank = {0};
+        results = blank;
+        assert(table_run(&config, &results));
+        cards_per_round[i] = (double)results.cards_dealt / results.rounds_dealt;
+    }
+
+    // About 2.7 cards per player hand plus the dealer's; the dealer skips
+    // drawing less often when more seats are still live
+    assert(cards_per_round[0] > 4.5 && cards_per_round[0] < 6.0);
+    assert(cards_per_round[1] > 19.0 && cards_per_round[1] < 24.0);
+}
+
+TEST(seats_keep_their_own_bets_and_ramps) {
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+
+    BetRamp ramp;
+    bet_ramp_flat(&ramp, 1.0);
+    for (int b = count_bucket_for_true_count(2); b < COUNT_NUM_BUCKETS; b++) {
+        ramp.units[b] = 8.0;
+    }
+
+    TableConfig config;
+    table_config_init(&config, 3, 20000);
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+    config.seats[1].bet_per_hand = 5.0;
+    config.seats[2].bet_ramp = &ramp;
+
+    TableResults blank = {0};
+    results = blank;
+    assert(table_run(&config, &results));
+
+    // Doubles and splits aside, a flat 5-unit seat wagers five times as much
+    double ratio = results.seats[1].total_bet / results.seats[0].total_bet;
+    assert(ratio > 4.5 && ratio < 5.5);
+
+    // The ramping seat only raises at +2 and up
+    double average_bet = results.seats[2].total_bet / results.seats[2].hands_played;
+    assert(average_bet > results.seats[0].total_bet / results.seats[0].hands_played);
+    assert(average_bet < 4.0);
+
+    // Every seat's rounds land in the shared count's buckets
+    for (int s = 0; s < config.num_seats; s++) {
+        long recorded = 0;
+        for (int b = 0; b < COUNT_NUM_BUCKETS; b++) {
+            recorded += results.seats[s].count_tables[0].buckets[b].rounds;
+        }
+        assert(recorded == 20000);
+    }
+}
+
+TEST(invalid_tables_are_refused) {
+    CountSystem hi_lo;
+    count_system_hi_lo(&hi_lo);
+    BetRamp ramp;
+    bet_ramp_flat(&ramp, 1.0);
+
+    TableConfig config;
+    table_config_init(&config, 2, 100);
+    config.count_systems = &hi_lo;
+    config.num_count_systems = 1;
+    config.seats[1].bet_ramp = &ramp;
+    assert(table_config_valid(&config));
+
+    config.seats[1].count_system = 1;            // The table counts only one system
+    assert(!table_config_valid(&config));
+    config.seats[1].count_system = -1;
+    assert(!table_config_valid(&config));
+    config.seats[1].count_system = 0;
+
+    config.num_seats = 0;
+    assert(!table_config_valid(&config));
+    config.num_seats = TABLE_MAX_SEATS + 1;
+    assert(!table_config_valid(&config));
+
+    TableResults blank = {0};
+    results = blank;
+    assert(!table_run(&config, &results));
+    assert(results.rounds_dealt == 0);
+}
+
+int main(void) {
+    printf("Running Table Tests\n");
+    printf("==================================\n\n");
+
+    run_test_every_seat_plays_every_round();
+    run_test_card_consumption_grows_with_seats();
+    run_test_seats_keep_their_own_bets_and_ramps();
+    run_test_invalid_tables_are_refused();
+
+    printf("\n==================================\n");
+    printf("Tests passed: %d/%d\n", tests_passed, tests_run);
+
+    if (tests_passed == tests_run) {
+        printf("All tests passed! ✓\n");
+        return 0;
+    } else {
+        printf("Some tests failed! ✗\n");
+        return 1;
+    }
+}
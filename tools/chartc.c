@@ -0,0 +1,105 @@
+// Strategy chart compiler: reads charts/*.chart (parsed by src/chart.c) and
+// writes a header of static const BasicStrategy tables for strategy.c.
+//
+// Usage: chartc OUTPUT CHART...
+//
+// The output is only written once every chart has parsed, so a bad chart
+// fails the build instead of leaving a half-written header behind.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chart.h"
+
+#define MAX_CHARTS 64
+#define NUM_UPCARDS 10
+
+static const char* upcard_labels[NUM_UPCARDS] = { "2", "3", "4", "5", "6", "7", "8", "9", "T", "A" };
+static const char* player_action_names[] = { "HIT", "STAND", "DOUBLE", "SPLIT", "SURRENDER" };
+static const char* soft_action_names[] = { "SOFT_HIT", "SOFT_STAND", "SOFT_DOUBLE_OR_HIT", "SOFT_DOUBLE_OR_STAND" };
+static const char* split_action_names[] = { "YES", "NO", "YES_IF_SPLIT_OFFERED" };
+static const char* bool_names[] = { "false", "true" };
+
+typedef struct {
+    char name[CHART_NAME_LENGTH];
+    const char* path;
+    BasicStrategy strategy;
+} Chart;
+
+static Chart charts[MAX_CHARTS];
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(((const Chart*)a)->name, ((const Chart*)b)->name);
+}
+
+static void write_table(FILE* out, const char* field, const uint8_t* cells, int num_hands, const char** names) {
+    fprintf(out, "            .%s = {\n", field);
+    for (int up = 0; up < NUM_UPCARDS; up++) {
+        fprintf(out, "                {");
+        for (int h = 0; h < num_hands; h++) {
+            fprintf(out, " %s%s", names[cells[up * num_hands + h]], h + 1 < num_hands ? "," : "");
+        }
+        fprintf(out, " },  // Dealer %s\n", upcard_labels[up]);
+    }
+    fprintf(out, "            },\n");
+}
+
+static void write_chart(FILE* out, const Chart* chart) {
+    const BasicStrategy* strategy = &chart->strategy;
+    fprintf(out, "    {\n        \"%s\",\n        {\n", chart->name);
+    write_table(out, "hard_totals", &strategy->hard_totals[0][0], 9, player_action_names);
+    write_table(out, "soft_totals", &strategy->soft_totals[0][0], 8, soft_action_names);
+    write_table(out, "pairs", &strategy->pairs[0][0], 10, split_action_names);
+    write_table(out, "surrender", (const uint8_t*)&strategy->surrender[0][0], 3, bool_names);
+    fprintf(out, "        },\n    },\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s OUTPUT CHART...\n", argv[0]);
+        return 1;
+    }
+
+    int num_charts = argc - 2;
+    if (num_charts > MAX_CHARTS) {
+        fprintf(stderr, "%s: at most %d charts\n", argv[0], MAX_CHARTS);
+        return 1;
+    }
+
+    for (int c = 0; c < num_charts; c++) {
+        charts[c].path = argv[c + 2];
+        if (!chart_load(charts[c].path, charts[c].name, &charts[c].strategy)) {
+            return 1;
+        }
+    }
+
+    // Sorted, so the header doesn't depend on the order make lists the charts in
+    qsort(charts, num_charts, sizeof(Chart), compare_names);
+    for (int c = 1; c < num_charts; c++) {
+        if (strcmp(charts[c - 1].name, charts[c].name) == 0) {
+            fprintf(stderr, "%s and %s are both chart '%s'\n", charts[c - 1].path, charts[c].path, charts[c].name);
+            return 1;
+        }
+    }
+
+    FILE* out = fopen(argv[1], "w");
+    if (out == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "// Generated by tools/chartc.c from charts/*.chart. Edit the charts, not this file.\n");
+    fprintf(out, "#pragma once\n\n");
+    fprintf(out, "#define STRATEGY_NUM_CHARTS %d\n\n", num_charts);
+    fprintf(out, "static const StrategyChart strategy_charts[STRATEGY_NUM_CHARTS] = {\n");
+    for (int c = 0; c < num_charts; c++) {
+        write_chart(out, &charts[c]);
+    }
+    fprintf(out, "};\n");
+
+    if (fclose(out) != 0) {
+        perror(argv[1]);
+        remove(argv[1]);
+        return 1;
+    }
+    return 0;
+}